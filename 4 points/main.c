@@ -8,6 +8,9 @@
 #include <fcntl.h>
 #include <semaphore.h>
 #include <signal.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../common/hugepages.h"
 
 #define SHM_NAME "/shm_are_cool"
 #define SEM_NAME "/sem_are_cool"
@@ -17,6 +20,7 @@ int num_processes;
 double *shared_area;
 sem_t *sem_area;
 double esp;
+size_t shm_size;
 
 double f(double x)
 {
@@ -73,11 +77,14 @@ int main(int argc, char *argv[])
     int fd_shm;
     pid_t pid;
 
-    if (argc != 4)
+    bool huge = false;
+
+    if (argc != 4 && !(argc == 5 && strcmp(argv[4], "--hugetlb") == 0))
     {
-        printf("Использование: %s <входной файл> <выходной> <кол-во процессов>\n", argv[0]);
+        printf("Использование: %s <входной файл> <выходной> <кол-во процессов> [--hugetlb]\n", argv[0]);
         exit(1);
     }
+    huge = argc == 5;
     if ((infile = fopen(argv[1], "r")) == NULL)
     {
         perror("Ошибка при открытии входного файла!\n");
@@ -104,12 +111,17 @@ int main(int argc, char *argv[])
         exit(1);
     }
     printf("Изменяем размер общей памяти...\n");
-    if (ftruncate(fd_shm, sizeof(int) + sizeof(double) * num_processes) == -1)
+    shm_size = sizeof(int) + sizeof(double) * num_processes;
+    if (huge)
+    {
+        shm_size = huge_round(shm_size);
+    }
+    if (ftruncate(fd_shm, shm_size) == -1)
     {
         perror("Ошибка при изменении размера shared memory");
         exit(1);
     }
-    if ((shared_area = mmap(NULL, sizeof(double), PROT_READ | PROT_WRITE, MAP_SHARED, fd_shm, 0)) == MAP_FAILED)
+    if ((shared_area = map_shared(fd_shm, shm_size, huge)) == MAP_FAILED)
     {
         perror("Ошибка при разметке shared memory");
         exit(1);
@@ -5,6 +5,9 @@
 #include <sys/sem.h>
 #include <unistd.h>
 #include <signal.h>
+#include <string.h>
+#include <stdbool.h>
+#include "../common/hugepages.h"
 
 #define SEM_KEY 1234 // ключ для семафоров
 #define SHM_KEY 5678 // ключ для разделяемой памяти
@@ -87,12 +90,14 @@ int main(int argc, char *argv[])
     struct sembuf sem_op; // структура для выполнения операций над семафорами
     FILE *infile, *outfile;
     double a, b;
+    bool huge = false;
 
-    if (argc != 4)
+    if (argc != 4 && !(argc == 5 && strcmp(argv[4], "--hugetlb") == 0))
     {
-        printf("Использование: %s <входной файл> <выходной> <кол-во процессов>\n", argv[0]);
+        printf("Использование: %s <входной файл> <выходной> <кол-во процессов> [--hugetlb]\n", argv[0]);
         exit(1);
     }
+    huge = argc == 5;
     if ((infile = fopen(argv[1], "r")) == NULL)
     {
         perror("Ошибка при открытии входного файла!\n");
@@ -131,7 +136,7 @@ int main(int argc, char *argv[])
     }
 
     // Создаем разделяемую память
-    if ((shmid = shmget(SHM_KEY, sizeof(double), IPC_CREAT | 0666)) == -1)
+    if ((shmid = get_shared(SHM_KEY, sizeof(double), huge)) == -1)
     {
         perror("Ошибка при создании разделяемой памяти");
         exit(1);
@@ -8,15 +8,36 @@
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <semaphore.h>
+#include <time.h>
+#include <sys/stat.h>
 
 #define SHM_NAME "/shared_memory"
 #define SEM_NAME "/shared_semaphore"
+#define LEASE_SEC 5          // сколько счетовод может молчать, прежде чем его район отдадут другим
+#define POLL_USEC 10000      // как часто свободный счетовод ищет брошенные районы
+#define HEARTBEAT_EVERY 1024 // через сколько точек счетовод подаёт признак жизни
+
+enum
+{
+    CHUNK_FREE,     // район ещё никто не брал
+    CHUNK_TAKEN,    // район считает счетовод owner
+    CHUNK_REISSUED, // счетовод пропал, район ждёт другого
+    CHUNK_DONE      // площадь района уже в общей сумме
+};
+
+typedef struct
+{
+    pid_t owner;      // pid счетовода, взявшего район
+    time_t heartbeat; // последний признак жизни счетовода
+    int state;
+} chunk_t;
 
 typedef struct
 {
     double sum;
     int num_clients;
     int client_id;
+    chunk_t chunks[];
 } shared_data_t;
 
 shared_data_t *shared_area;
@@ -26,7 +47,7 @@ double f(double x)
     return x * x / 1000.0;
 }
 
-double integrate(double a, double b, int all_op)
+double integrate(double a, double b, int all_op, chunk_t *chunk)
 {
     double h = (b - a) / all_op;
     double sum = 0.0;
@@ -34,25 +55,71 @@ double integrate(double a, double b, int all_op)
     int i;
     for (i = 0; i < all_op; i++)
     {
+        if (i % HEARTBEAT_EVERY == 0)
+        {
+            chunk->heartbeat = time(NULL);
+        }
         x = a + (i + 0.5) * h;
         sum += f(x);
     }
     return h * sum;
 }
 
-void child_process(int i, double a, double b, int all_op, FILE *outfile)
+double child_process(int i, double a, double b, int all_op, FILE *outfile)
 {
     double area;
     if (i > all_op)
     {
-        return;
+        return 0.0;
     }
     double step = (b - a) / (double)all_op;
-    area = integrate(a + (step * (double)(i - 1)), a + (step * (double)i), all_op);
-    shared_area->sum += area;
+    area = integrate(a + (step * (double)(i - 1)), a + (step * (double)i), all_op, &shared_area->chunks[i - 1]);
     fprintf(outfile, "Счетовод [%d] считал %.2f - %.2f и получил: ", i, a + (step * (double)(i - 1)), a + (step * (double)i));
     fprintf(outfile, "%lf кв.м\n", area);
-    return;
+    return area;
+}
+
+bool lease_expired(const chunk_t *chunk, time_t now)
+{
+    return (kill(chunk->owner, 0) == -1 && errno == ESRCH) || now - chunk->heartbeat > LEASE_SEC;
+}
+
+// Берёт район под семафором. Новый счетовод берёт свободный район,
+// а закончивший свой помогает только с районами пропавших счетоводов.
+// Возвращает номер района (с 1) или 0, если брать нечего.
+int claim_chunk(bool fresh)
+{
+    time_t now = time(NULL);
+    int found = 0;
+    for (int i = 0; i < shared_area->client_id && found == 0; i++)
+    {
+        chunk_t *chunk = &shared_area->chunks[i];
+        if ((fresh && chunk->state == CHUNK_FREE) || chunk->state == CHUNK_REISSUED ||
+            (chunk->state == CHUNK_TAKEN && lease_expired(chunk, now)))
+        {
+            found = i + 1;
+        }
+    }
+    if (found != 0)
+    {
+        shared_area->chunks[found - 1].owner = getpid();
+        shared_area->chunks[found - 1].heartbeat = now;
+        shared_area->chunks[found - 1].state = CHUNK_TAKEN;
+    }
+    return found;
+}
+
+// Есть ли районы, которые сейчас считают другие счетоводы
+bool work_in_progress(void)
+{
+    for (int i = 0; i < shared_area->client_id; i++)
+    {
+        if (shared_area->chunks[i].state == CHUNK_TAKEN || shared_area->chunks[i].state == CHUNK_REISSUED)
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 int main(int argc, char *argv[])
@@ -93,8 +160,16 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+    // Размер памяти зависит от числа районов, узнаём его у самого объекта
+    struct stat shm_stat;
+    if (fstat(shm_fd, &shm_stat) == -1)
+    {
+        perror("Ошибка при получении размера разделяемой памяти");
+        exit(1);
+    }
+
     // Отображаем разделяемую память в адресное пространство процесса
-    shared_area = mmap(NULL, sizeof(shared_data_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    shared_area = mmap(NULL, shm_stat.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
     if (shared_area == MAP_FAILED)
     {
         perror("Ошибка при отображении разделяемой памяти");
@@ -112,29 +187,54 @@ int main(int argc, char *argv[])
     // Получаем текущее значение семафора
     int sem_value;
     sem_getvalue(sem, &sem_value);
-    int client_id = shared_area->num_clients + 1;
-
-    printf("Счетовод %d запущен. Текущее значение семафора: %d\n", client_id, sem_value);
-
-    // Ожидаем разрешения на доступ к разделяемой памяти
-    sem_wait(sem);
+    printf("Счетовод (pid %d) запущен. Текущее значение семафора: %d\n", (int)getpid(), sem_value);
 
-    // Доступ к разделяемой памяти
-    child_process(client_id, a, b, shared_area->client_id, outfile);
-    printf("Счетовод %d: общая сумма = %f\n", client_id, shared_area->sum);
-    shared_area->num_clients += 1;
-
-    // Освобождаем разделяемую память
-    sem_post(sem);
+    bool fresh = true;
+    while (true)
+    {
+        // Берём район, пока его не взял кто-то другой
+        sem_wait(sem);
+        int client_id = claim_chunk(fresh);
+        bool pending = client_id == 0 && work_in_progress();
+        sem_post(sem);
+        if (client_id == 0)
+        {
+            // Ждём, не бросит ли кто-нибудь свой район
+            if (!pending)
+            {
+                break;
+            }
+            usleep(POLL_USEC);
+            continue;
+        }
+        if (!fresh)
+        {
+            printf("Счетовод (pid %d) подхватил брошенный район %d\n", (int)getpid(), client_id);
+        }
+        fresh = false;
+
+        double area = child_process(client_id, a, b, shared_area->client_id, outfile);
+
+        // Район мог успеть досчитать другой счетовод, тогда площадь второй раз не прибавляем
+        sem_wait(sem);
+        if (shared_area->chunks[client_id - 1].state != CHUNK_DONE)
+        {
+            shared_area->chunks[client_id - 1].state = CHUNK_DONE;
+            shared_area->sum += area;
+            shared_area->num_clients += 1;
+            printf("Счетовод %d: общая сумма = %f\n", client_id, shared_area->sum);
+        }
+        sem_post(sem);
+    }
 
     // Закрываем разделяемую память
-    munmap(shared_area, sizeof(shared_data_t));
+    munmap(shared_area, shm_stat.st_size);
     close(shm_fd);
 
     // Закрываем семафор
     sem_close(sem);
     fclose(outfile);
     fclose(infile);
-    printf("Счетовод %d завершен\n", client_id);
+    printf("Счетовод (pid %d) завершен\n", (int)getpid());
     return 0;
 }
\ No newline at end of file
@@ -8,30 +8,71 @@
 #include <sys/mman.h>
 #include <fcntl.h>
 #include <semaphore.h>
+#include <time.h>
+#include "../common/hugepages.h"
 
 #define SHM_NAME "/shared_memory"
 #define SEM_NAME "/shared_semaphore"
 #define NUM_CLIENTS 5
+#define LEASE_SEC 5       // сколько счетовод может молчать, прежде чем его район отдадут другим
+#define POLL_USEC 10000   // как часто агроном проверяет районы
+
+enum
+{
+    CHUNK_FREE,     // район ещё никто не брал
+    CHUNK_TAKEN,    // район считает счетовод owner
+    CHUNK_REISSUED, // счетовод пропал, район ждёт другого
+    CHUNK_DONE      // площадь района уже в общей сумме
+};
+
+typedef struct
+{
+    pid_t owner;      // pid счетовода, взявшего район
+    time_t heartbeat; // последний признак жизни счетовода
+    int state;
+} chunk_t;
 
 typedef struct
 {
     double sum;
     int count;
     int num_clients;
+    chunk_t chunks[]; // по району на каждого счетовода
 } shared_data_t;
 
 shared_data_t *shared_data;
 sem_t *semaphore;
+size_t shm_size;
 
 void cleanup()
 {
     // Удаляем семафор и разделяемую память
     sem_close(semaphore);
     sem_unlink(SEM_NAME);
-    munmap(shared_data, sizeof(shared_data_t));
+    munmap(shared_data, shm_size);
     shm_unlink(SHM_NAME);
 }
 
+bool lease_expired(const chunk_t *chunk, time_t now)
+{
+    return (kill(chunk->owner, 0) == -1 && errno == ESRCH) || now - chunk->heartbeat > LEASE_SEC;
+}
+
+// Возвращает в работу районы счетоводов, которые умерли или перестали подавать признаки жизни
+void reissue_orphans(shared_data_t *data)
+{
+    time_t now = time(NULL);
+    for (int i = 0; i < data->num_clients; i++)
+    {
+        chunk_t *chunk = &data->chunks[i];
+        if (chunk->state == CHUNK_TAKEN && lease_expired(chunk, now))
+        {
+            printf("Счетовод (pid %d) пропал, район %d отдаём другим\n", (int)chunk->owner, i + 1);
+            chunk->state = CHUNK_REISSUED;
+        }
+    }
+}
+
 void sigint_handler(int signum)
 {
     cleanup();
@@ -41,11 +82,13 @@ void sigint_handler(int signum)
 int main(int argc, char *argv[])
 {
     FILE *infile, *outfile;
-    if (argc != 4)
+    bool huge = false;
+    if (argc != 4 && !(argc == 5 && strcmp(argv[4], "--hugetlb") == 0))
     {
-        fprintf(stderr, "Использование: %s <файл ввода> <файл вывода> <кол-во независимых процессов>\n", argv[0]);
+        fprintf(stderr, "Использование: %s <файл ввода> <файл вывода> <кол-во независимых процессов> [--hugetlb]\n", argv[0]);
         exit(1);
     }
+    huge = argc == 5;
     if ((infile = fopen(argv[1], "r")) == NULL)
     {
         perror("Ошибка при открытии входного файла!\n");
@@ -78,14 +121,19 @@ int main(int argc, char *argv[])
     }
 
     // Устанавливаем размер разделяемой памяти
-    if (ftruncate(shm_fd, sizeof(shared_data_t)) == -1)
+    shm_size = sizeof(shared_data_t) + sizeof(chunk_t) * num_processes;
+    if (huge)
+    {
+        shm_size = huge_round(shm_size);
+    }
+    if (ftruncate(shm_fd, shm_size) == -1)
     {
         perror("Ошибка при изменении размера разделяемой памяти");
         exit(1);
     }
 
     // Отображаем разделяемую память в адресное пространство текущего процесса
-    shared_data = mmap(NULL, sizeof(shared_data_t), PROT_READ | PROT_WRITE, MAP_SHARED, shm_fd, 0);
+    shared_data = map_shared(shm_fd, shm_size, huge);
     if (shared_data == MAP_FAILED)
     {
         perror("Ошибка при отображении разделяемой памяти");
@@ -96,8 +144,12 @@ int main(int argc, char *argv[])
     shared_data->sum = 0;
     shared_data->count = 0;
     shared_data->num_clients = num_processes;
+    for (int i = 0; i < num_processes; i++)
+    {
+        shared_data->chunks[i].state = CHUNK_FREE;
+    }
 
-    // Ожидаем завершения всех счетоводов.
+    // Ожидаем завершения всех районов, попутно отбирая районы у пропавших счетоводов.
     while (true)
     {
         sem_wait(semaphore);
@@ -105,7 +157,9 @@ int main(int argc, char *argv[])
         {
             break;
         }
+        reissue_orphans(shared_data);
         sem_post(semaphore);
+        usleep(POLL_USEC);
     }
 
     if ((outfile = fopen(argv[2], "w")) == NULL)
@@ -6,15 +6,39 @@
 #include <sys/sem.h>
 #include <sys/shm.h>
 #include <signal.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <time.h>
 
 #define SHM_KEY 3213
 #define SEM_KEY 6232
+#define SEM_REPORT 0         // счетовод отчитался о районе
+#define SEM_MUTEX 1          // доступ к разделяемой памяти
+#define LEASE_SEC 5          // сколько счетовод может молчать, прежде чем его район отдадут другим
+#define POLL_USEC 10000      // как часто свободный счетовод ищет брошенные районы
+#define HEARTBEAT_EVERY 1024 // через сколько точек счетовод подаёт признак жизни
+
+enum
+{
+    CHUNK_FREE,     // район ещё никто не брал
+    CHUNK_TAKEN,    // район считает счетовод owner
+    CHUNK_REISSUED, // счетовод пропал, район ждёт другого
+    CHUNK_DONE      // площадь района уже в общей сумме
+};
+
+typedef struct
+{
+    pid_t owner;      // pid счетовода, взявшего район
+    time_t heartbeat; // последний признак жизни счетовода
+    int state;
+} chunk_t;
 
 typedef struct
 {
     double sum;
     int num_clients_completed;
     int num_clients_total;
+    chunk_t chunks[];
 } shared_data_t;
 
 shared_data_t *shared_data_ptr;
@@ -26,7 +50,7 @@ double f(double x)
     return x * x / 1000.0;
 }
 
-double integrate(double a, double b, int all_op)
+double integrate(double a, double b, int all_op, chunk_t *chunk)
 {
     double h = (b - a) / all_op;
     double sum = 0.0;
@@ -34,23 +58,80 @@ double integrate(double a, double b, int all_op)
     int i;
     for (i = 0; i < all_op; i++)
     {
+        if (i % HEARTBEAT_EVERY == 0)
+        {
+            chunk->heartbeat = time(NULL);
+        }
         x = a + (i + 0.5) * h;
         sum += f(x);
     }
     return h * sum;
 }
 
-void child_process(int i, double a, double b, int all_op)
+double child_process(int i, double a, double b, int all_op)
 {
     double area;
     if (i > all_op)
     {
-        return;
+        return 0.0;
     }
     double step = (b - a) / (double)all_op;
-    area = integrate(a + (step * (double)(i - 1)), a + (step * (double)i), all_op);
-    shared_data_ptr->sum += area;
-    return;
+    area = integrate(a + (step * (double)(i - 1)), a + (step * (double)i), all_op, &shared_data_ptr->chunks[i - 1]);
+    return area;
+}
+
+int sem_change(int num, int op)
+{
+    struct sembuf sem_op = {num, op, 0};
+    if (semop(semid, &sem_op, 1) == -1)
+    {
+        perror("Ошибка при работе с семафором");
+        exit(1);
+    }
+    return 0;
+}
+
+bool lease_expired(const chunk_t *chunk, time_t now)
+{
+    return (kill(chunk->owner, 0) == -1 && errno == ESRCH) || now - chunk->heartbeat > LEASE_SEC;
+}
+
+// Берёт район под семафором. Новый счетовод берёт свободный район,
+// а закончивший свой помогает только с районами пропавших счетоводов.
+// Возвращает номер района (с 1) или 0, если брать нечего.
+int claim_chunk(bool fresh)
+{
+    time_t now = time(NULL);
+    int found = 0;
+    for (int i = 0; i < shared_data_ptr->num_clients_total && found == 0; i++)
+    {
+        chunk_t *chunk = &shared_data_ptr->chunks[i];
+        if ((fresh && chunk->state == CHUNK_FREE) || chunk->state == CHUNK_REISSUED ||
+            (chunk->state == CHUNK_TAKEN && lease_expired(chunk, now)))
+        {
+            found = i + 1;
+        }
+    }
+    if (found != 0)
+    {
+        shared_data_ptr->chunks[found - 1].owner = getpid();
+        shared_data_ptr->chunks[found - 1].heartbeat = now;
+        shared_data_ptr->chunks[found - 1].state = CHUNK_TAKEN;
+    }
+    return found;
+}
+
+// Есть ли районы, которые сейчас считают другие счетоводы
+bool work_in_progress(void)
+{
+    for (int i = 0; i < shared_data_ptr->num_clients_total; i++)
+    {
+        if (shared_data_ptr->chunks[i].state == CHUNK_TAKEN || shared_data_ptr->chunks[i].state == CHUNK_REISSUED)
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
 void signal_handler(int sig)
@@ -88,8 +169,8 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
-    // Получение доступа к разделяемой памяти
-    if ((shmid = shmget(SHM_KEY, sizeof(shared_data_t), 0666)) == -1)
+    // Получение доступа к разделяемой памяти, её размер знает только агроном
+    if ((shmid = shmget(SHM_KEY, 0, 0666)) == -1)
     {
         perror("Ошибка при получении доступа к разделяемой памяти");
         exit(1);
@@ -103,7 +184,7 @@ int main(int argc, char *argv[])
     }
 
     // Получение доступа к семафору
-    if ((semid = semget(SEM_KEY, 1, 0666)) == -1)
+    if ((semid = semget(SEM_KEY, 2, 0666)) == -1)
     {
         perror("Ошибка при получении доступа к семафору");
         exit(1);
@@ -118,23 +199,48 @@ int main(int argc, char *argv[])
         usleep(100);
     }
 
-    int client_num = shared_data_ptr->num_clients_completed + 1;
-
-    printf("Счетовод %d запущен!\n", client_num);
-    struct sembuf sem_op;
-    sem_op.sem_num = 0;
-    sem_op.sem_op = 1;
-    sem_op.sem_flg = 0;
-    if (semop(semid, &sem_op, 1) == -1)
+    printf("Счетовод (pid %d) запущен!\n", (int)getpid());
+    bool fresh = true;
+    while (true)
     {
-        perror("Ошибка при отправке сигнала серверу");
-        exit(1);
+        // Берём район, пока его не взял кто-то другой
+        sem_change(SEM_MUTEX, -1);
+        int client_num = claim_chunk(fresh);
+        bool pending = client_num == 0 && work_in_progress();
+        sem_change(SEM_MUTEX, 1);
+        if (client_num == 0)
+        {
+            // Ждём, не бросит ли кто-нибудь свой район
+            if (!pending)
+            {
+                break;
+            }
+            usleep(POLL_USEC);
+            continue;
+        }
+        if (!fresh)
+        {
+            printf("Счетовод (pid %d) подхватил брошенный район %d\n", (int)getpid(), client_num);
+        }
+        fresh = false;
+
+        double area = child_process(client_num, a, b, shared_data_ptr->num_clients_total);
+
+        // Район мог успеть досчитать другой счетовод, тогда площадь второй раз не прибавляем
+        sem_change(SEM_MUTEX, -1);
+        if (shared_data_ptr->chunks[client_num - 1].state != CHUNK_DONE)
+        {
+            shared_data_ptr->chunks[client_num - 1].state = CHUNK_DONE;
+            shared_data_ptr->sum += area;
+            shared_data_ptr->num_clients_completed++;
+            printf("Счетовод %d: общая сумма = %f\n", client_num, shared_data_ptr->sum);
+        }
+        sem_change(SEM_MUTEX, 1);
+        // Сообщаем агроному об отчёте
+        sem_change(SEM_REPORT, 1);
     }
-    child_process(client_num, a, b, shared_data_ptr->num_clients_total);
-    printf("Счетовод %d: общая сумма = %f\n", client_num, shared_data_ptr->sum);
-    shared_data_ptr->num_clients_completed++;
 
-    printf("Счетовод %d завершен\n", client_num);
+    printf("Счетовод (pid %d) завершен\n", (int)getpid());
     fclose(infile);
     // Отключение от разделяемой памяти
     if (shmdt(shared_data_ptr) == -1)
@@ -1,3 +1,4 @@
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
@@ -7,21 +8,70 @@
 #include <sys/shm.h>
 #include <sys/sem.h>
 #include <errno.h>
+#include <string.h>
+#include <time.h>
+#include "../common/hugepages.h"
 
 #define SHM_KEY 3213
 #define SEM_KEY 6232
+#define SEM_REPORT 0    // счетовод отчитался о районе
+#define SEM_MUTEX 1     // доступ к разделяемой памяти
+#define LEASE_SEC 5     // сколько счетовод может молчать, прежде чем его район отдадут другим
+#define POLL_NSEC 10000000 // как долго агроном ждёт отчёта, прежде чем проверить районы
+
+enum
+{
+    CHUNK_FREE,     // район ещё никто не брал
+    CHUNK_TAKEN,    // район считает счетовод owner
+    CHUNK_REISSUED, // счетовод пропал, район ждёт другого
+    CHUNK_DONE      // площадь района уже в общей сумме
+};
+
+struct chunk
+{
+    pid_t owner;      // pid счетовода, взявшего район
+    time_t heartbeat; // последний признак жизни счетовода
+    int state;
+};
 
 struct shared_data
 {
     double sum;
     int num_clients_completed;
     int num_clients_total;
+    struct chunk chunks[]; // по району на каждого счетовода
 };
 
 int shmid;
 int semid;
 struct shared_data *shared_data_ptr;
 
+int sem_change(int num, int op)
+{
+    struct sembuf sem_op = {num, op, 0};
+    return semop(semid, &sem_op, 1);
+}
+
+bool lease_expired(const struct chunk *chunk, time_t now)
+{
+    return (kill(chunk->owner, 0) == -1 && errno == ESRCH) || now - chunk->heartbeat > LEASE_SEC;
+}
+
+// Возвращает в работу районы счетоводов, которые умерли или перестали подавать признаки жизни
+void reissue_orphans(struct shared_data *data)
+{
+    time_t now = time(NULL);
+    for (int i = 0; i < data->num_clients_total; i++)
+    {
+        struct chunk *chunk = &data->chunks[i];
+        if (chunk->state == CHUNK_TAKEN && lease_expired(chunk, now))
+        {
+            printf("Счетовод (pid %d) пропал, район %d отдаём другим\n", (int)chunk->owner, i + 1);
+            chunk->state = CHUNK_REISSUED;
+        }
+    }
+}
+
 void sigint_handler(int sig)
 {
     printf("\nПринят сигнал SIGINT. Завершение работы сервера.\n");
@@ -50,11 +100,13 @@ void sigint_handler(int sig)
 int main(int argc, char *argv[])
 {
     FILE *infile, *outfile;
-    if (argc != 4)
+    bool huge = false;
+    if (argc != 4 && !(argc == 5 && strcmp(argv[4], "--hugetlb") == 0))
     {
-        fprintf(stderr, "Использование: %s <файл ввода> <файл вывода> <кол-во независимых проццессов>\n", argv[0]);
+        fprintf(stderr, "Использование: %s <файл ввода> <файл вывода> <кол-во независимых проццессов> [--hugetlb]\n", argv[0]);
         exit(1);
     }
+    huge = argc == 5;
     if ((infile = fopen(argv[1], "r")) == NULL)
     {
         perror("Ошибка при открытии входного файла!\n");
@@ -71,8 +123,15 @@ int main(int argc, char *argv[])
     // Установка обработчика сигнала SIGINT
     signal(SIGINT, sigint_handler);
 
+    // Сегмент прошлого запуска мог быть меньше, чем нужно сейчас
+    if ((shmid = shmget(SHM_KEY, 0, 0666)) != -1)
+    {
+        shmctl(shmid, IPC_RMID, NULL);
+    }
+
     // Создание/подключение к разделяемой памяти
-    if ((shmid = shmget(SHM_KEY, sizeof(struct shared_data), IPC_CREAT | 0666)) == -1)
+    size_t shm_size = sizeof(struct shared_data) + sizeof(struct chunk) * num_processes;
+    if ((shmid = get_shared(SHM_KEY, shm_size, huge)) == -1)
     {
         perror("Ошибка при создании/подключении к разделяемой памяти");
         exit(1);
@@ -84,22 +143,22 @@ int main(int argc, char *argv[])
     }
 
     // Создание/подключение к семафорам
-    int semid;
-    if ((semid = semget(SEM_KEY, 1, IPC_CREAT | 0666)) == -1)
+    if ((semid = semget(SEM_KEY, 2, IPC_CREAT | 0666)) == -1)
     {
         perror("Ошибка при создании/подключении к семафорам");
         exit(1);
     }
 
-    // Инициализация семафора
+    // Инициализация семафоров: отчётов ещё нет, память свободна
     union semun
     {
         int val;
         struct semid_ds *buf;
-        short *array;
+        unsigned short *array;
     } arg;
-    arg.val = 1;
-    if (semctl(semid, 0, SETVAL, arg) == -1)
+    unsigned short values[2] = {0, 1};
+    arg.array = values;
+    if (semctl(semid, 0, SETALL, arg) == -1)
     {
         perror("Ошибка при инициализации семафора");
         exit(1);
@@ -108,36 +167,49 @@ int main(int argc, char *argv[])
     // Инициализация разделяемой памяти
     shared_data_ptr->sum = 0;
     shared_data_ptr->num_clients_completed = 0;
+    for (int i = 0; i < num_processes; i++)
+    {
+        shared_data_ptr->chunks[i].state = CHUNK_FREE;
+    }
+    // Счетоводы ждут, пока не появится общее число районов, поэтому оно пишется последним
     shared_data_ptr->num_clients_total = num_processes;
 
-    // Ожидание завершения всех клиентов
-    double answer;
-    while (shared_data_ptr->num_clients_completed < num_processes)
-    {
-        // Ожидание сигнала от клиента
-        struct sembuf sem_op;
-        sem_op.sem_num = 0;
-        sem_op.sem_op = -1;
-        sem_op.sem_flg = 0;
-        if (semop(semid, &sem_op, 1) == -1)
+    // Ожидание завершения всех районов
+    double answer = 0.0;
+    int reported = 0;
+    struct timespec poll = {0, POLL_NSEC};
+    // Завершение проверяется и сумма читается под мьютексом: иначе последний район,
+    // добавленный между освобождением мьютекса и проверкой, не попал бы в ответ
+    while (true)
+    {
+        // Ожидание отчёта от клиента, по таймауту проверяем, живы ли счетоводы
+        struct sembuf sem_op = {SEM_REPORT, -1, 0};
+        if (semtimedop(semid, &sem_op, 1, &poll) == -1)
         {
-            perror("Ошибка при ожидании сигнала от клиента");
+            if (errno != EAGAIN && errno != EINTR)
+            {
+                perror("Ошибка при ожидании сигнала от клиента");
+                exit(1);
+            }
+        }
+        if (sem_change(SEM_MUTEX, -1) == -1)
+        {
+            perror("Ошибка при захвате разделяемой памяти");
             exit(1);
         }
-        if (shared_data_ptr->num_clients_completed > 0)
+        if (shared_data_ptr->num_clients_completed > reported)
         {
-            printf("Счетовод %d отработал, текущая сумма: %f\n",
-                   shared_data_ptr->num_clients_completed, shared_data_ptr->sum);
-            answer = shared_data_ptr->sum;
+            reported = shared_data_ptr->num_clients_completed;
+            printf("Счетоводы отработали %d районов, текущая сумма: %f\n", reported, shared_data_ptr->sum);
         }
-
-        // Сигнал клиенту о завершении обновления
-        sem_op.sem_num = 1;
-        sem_op.sem_op = 1;
-        sem_op.sem_flg = 0;
-        if (semop(semid, &sem_op, 1) == -1)
+        answer = shared_data_ptr->sum;
+        if (shared_data_ptr->num_clients_completed == num_processes)
         {
+            sem_change(SEM_MUTEX, 1);
+            break;
         }
+        reissue_orphans(shared_data_ptr);
+        sem_change(SEM_MUTEX, 1);
     }
     if ((outfile = fopen(argv[2], "w")) == NULL)
     {
@@ -0,0 +1,130 @@
+#include <math.h>
+#include "area.h"
+
+#define MAX_DEPTH 30 // глубина деления панели пополам при адаптивном уточнении
+
+// Функция из библиотеки, которую считает этот поток, NULL - профиль river
+static __thread area_fn_t thread_fn;
+static __thread void *thread_context;
+
+// Для средних прямоугольников функция библиотеки видна как профиль без кусков
+static const profile_t handle_profile = {"handle", f, 0};
+
+double f(double x)
+{
+    if (thread_fn != NULL)
+    {
+        return thread_fn(x, thread_context);
+    }
+    return profile_eval(&river, x);
+}
+
+void area_use(area_fn_t fn, void *context)
+{
+    thread_fn = fn;
+    thread_context = context;
+}
+
+double integrate(double a, double b, int all_op)
+{
+    double h = (b - a) / all_op;
+    double sum = 0.0;
+    double x;
+    int i;
+    for (i = 0; i < all_op; i++)
+    {
+        x = a + (i + 0.5) * h;
+        sum += f(x);
+    }
+    return h * sum;
+}
+
+// Адаптивная квадратура: панель делится пополам, пока ошибка больше допуска.
+// Ошибки принятых панелей добавляются в *estimate.
+static double adapt(const rule_t *rule, double a, double b, double whole, double error, double tol, int depth,
+                    long long *evals, double *estimate)
+{
+    double m = (a + b) / 2, left_error, right_error, left, right;
+    if (error <= tol || depth >= MAX_DEPTH)
+    {
+        *estimate += error;
+        return whole;
+    }
+    left = rule->panel(a, m, &left_error);
+    right = rule->panel(m, b, &right_error);
+    *evals += 2 * rule->points;
+    if (!rule->embedded)
+    {
+        // Без встроенной оценки сравниваем панель с её двумя половинами
+        left_error = right_error = fabs(left + right - whole) / 2;
+    }
+    return adapt(rule, a, m, left, left_error, tol / 2, depth + 1, evals, estimate) +
+           adapt(rule, m, b, right, right_error, tol / 2, depth + 1, evals, estimate);
+}
+
+double integrate_region(const job_t *job, double from, double to, int all_op, long long *evals)
+{
+    return integrate_region_estimate(job, from, to, all_op, evals, NULL);
+}
+
+double integrate_region_estimate(const job_t *job, double from, double to, int all_op, long long *evals,
+                                 double *estimate)
+{
+    const profile_t *profile = thread_fn != NULL ? &handle_profile : &river;
+    double error, area, unused = 0.0;
+    if (job->tol > 0)
+    {
+        area = job->rule->panel(from, to, &error);
+        *evals += job->rule->points;
+        if (!job->rule->embedded)
+        {
+            error = INFINITY;
+        }
+        // Допуск делится между районами пропорционально их ширине
+        double share = job->b != job->a ? (to - from) / (job->b - job->a) : 1.0;
+        return adapt(job->rule, from, to, area, error, job->tol * share, 0, evals,
+                     estimate != NULL ? estimate : &unused);
+    }
+    if (job->rule == &rule_midpoint)
+    {
+        *evals += all_op;
+        area = job->precision->midpoint(profile, from, to, all_op);
+        if (estimate != NULL && all_op >= 2)
+        {
+            // Правило Рунге: ошибка средних прямоугольников ~h^2, сравниваем с вдвое меньшим числом шагов
+            *evals += all_op / 2;
+            *estimate += fabs(area - (double)job->precision->midpoint(profile, from, to, all_op / 2)) / 3;
+        }
+        else if (estimate != NULL)
+        {
+            *estimate = NAN;
+        }
+        return area;
+    }
+    *evals += job->rule->points;
+    area = job->rule->panel(from, to, &error);
+    if (estimate != NULL)
+    {
+        *estimate += job->rule->embedded ? error : NAN;
+    }
+    return area;
+}
+
+void job_method(const job_t *job, char *name, size_t size)
+{
+    if (job->precision == &precision_double)
+    {
+        snprintf(name, size, "%s", job->rule->name);
+    }
+    else
+    {
+        snprintf(name, size, "%s/%s", job->rule->name, job->precision->name);
+    }
+}
+
+void region_bounds(const job_t *job, int i, int all_op, double *from, double *to)
+{
+    double step = (job->b - job->a) / (double)all_op;
+    *from = job->a + (step * (double)(i - 1));
+    *to = job->a + (step * (double)i);
+}
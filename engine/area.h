@@ -0,0 +1,50 @@
+#ifndef AREA_H
+#define AREA_H
+
+#include <stdio.h>
+#include "rules.h"
+#include "profile.h"
+#include "precision.h"
+#include "libarea.h" // area_fn_t - функция f(x) вызывающей программы
+
+// Задание на подсчет площади
+typedef struct
+{
+    double a, b;        // границы территории по меридианам
+    const rule_t *rule; // квадратурное правило
+    double tol;         // допустимая ошибка на всю территорию, 0 - без уточнения
+    const precision_t *precision; // точность средних прямоугольников без уточнения
+} job_t;
+
+// Интервал территории и его площадь
+typedef struct
+{
+    double from, to;
+    double area;
+} interval_t;
+
+// Функция реки f(x), задается профилем river или area_use
+double f(double x);
+
+// Считать в этом потоке f(x) = fn(x, context) вместо профиля river, NULL - снова river
+void area_use(area_fn_t fn, void *context);
+
+// Площадь под f(x) на [a, b] методом средних прямоугольников из all_op шагов
+double integrate(double a, double b, int all_op);
+
+// Площадь района [from, to] по правилу задания, в *evals добавляется число вычислений f(x)
+double integrate_region(const job_t *job, double from, double to, int all_op, long long *evals);
+
+// То же, что integrate_region, а в *estimate добавляется оценка ошибки района: по вложенному
+// правилу или адаптивному уточнению, для средних прямоугольников - по правилу Рунге
+// (еще all_op / 2 вычислений f(x)), NAN - если правило ошибку не оценивает
+double integrate_region_estimate(const job_t *job, double from, double to, int all_op, long long *evals,
+                                 double *estimate);
+
+// Имя метода для ключей кэша и хранилища: правило, а для точности не double еще и она
+void job_method(const job_t *job, char *name, size_t size);
+
+// Границы i-го из all_op районов территории
+void region_bounds(const job_t *job, int i, int all_op, double *from, double *to);
+
+#endif
@@ -0,0 +1,112 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "area_index.h"
+
+#define NAME_SIZE 32
+#define SPEC_SIZE 1024
+
+int index_save(const char *path, const job_t *job, int all_op, const interval_t *items, int count)
+{
+    FILE *file;
+    double prefix = 0.0;
+    if ((file = fopen(path, "w")) == NULL)
+    {
+        perror("Ошибка при открытии файла индекса");
+        return -1;
+    }
+    // Заголовок: профиль реки, правило, точность, допуск, шагов на район и число районов,
+    // дальше граница и площадь до неё
+    fprintf(file, "%s %s %s %.17g %d %d\n", river.name, job->rule->name, job->precision->name, job->tol, all_op,
+            count);
+    for (int i = 0; i <= count; i++)
+    {
+        fprintf(file, "%.17g %.17g\n", i < count ? items[i].from : items[count - 1].to, prefix);
+        if (i < count)
+        {
+            prefix += items[i].area;
+        }
+    }
+    fclose(file);
+    return 0;
+}
+
+int index_load(const char *path, area_index_t *index)
+{
+    char spec[SPEC_SIZE], rule[NAME_SIZE], precision[NAME_SIZE];
+    FILE *file;
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        perror("Ошибка при открытии файла индекса");
+        return -1;
+    }
+    if (fscanf(file, "%1023s %31s %31s %lf %d %d", spec, rule, precision, &index->job.tol, &index->all_op,
+               &index->count) != 6 ||
+        index->count < 1 || index->all_op < 1 || index->job.tol < 0 || profile_parse(spec, &river) == -1 ||
+        (index->job.rule = rule_find(rule)) == NULL || (index->job.precision = precision_find(precision)) == NULL)
+    {
+        printf("Файл индекса %s поврежден\n", path);
+        fclose(file);
+        return -1;
+    }
+    index->x = malloc(sizeof(double) * (index->count + 1));
+    index->prefix = malloc(sizeof(double) * (index->count + 1));
+    for (int i = 0; i <= index->count; i++)
+    {
+        if (fscanf(file, "%lf %lf", &index->x[i], &index->prefix[i]) != 2)
+        {
+            printf("Файл индекса %s поврежден\n", path);
+            fclose(file);
+            index_free(index);
+            return -1;
+        }
+    }
+    fclose(file);
+    index->job.a = index->x[0];
+    index->job.b = index->x[index->count];
+    return 0;
+}
+
+// Площадь от начала участка до точки x: префикс до ближайшей левой границы
+// плюс досчитанный кусок неполного района
+static double area_to(const area_index_t *index, double x, long long *evals)
+{
+    int lo = 0, hi = index->count, mid;
+    if (x <= index->x[0])
+    {
+        return 0.0;
+    }
+    if (x >= index->x[index->count])
+    {
+        return index->prefix[index->count];
+    }
+    while (hi - lo > 1)
+    {
+        mid = (lo + hi) / 2;
+        if (index->x[mid] <= x)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if (x == index->x[lo])
+    {
+        return index->prefix[lo];
+    }
+    // Кусок района считаем тем же правилом, допуском, точностью и числом шагов, что и весь район
+    return index->prefix[lo] + integrate_region(&index->job, index->x[lo], x, index->all_op, evals);
+}
+
+double index_query(const area_index_t *index, double c, double d, long long *evals)
+{
+    return area_to(index, d, evals) - area_to(index, c, evals);
+}
+
+void index_free(area_index_t *index)
+{
+    free(index->x);
+    free(index->prefix);
+    index->x = index->prefix = NULL;
+}
@@ -0,0 +1,29 @@
+#ifndef AREA_INDEX_H
+#define AREA_INDEX_H
+
+#include "area.h"
+
+// Индекс площадей посчитанного участка: границы районов x[0] < ... < x[count]
+// и площади от x[0] до каждой границы (префиксные суммы)
+typedef struct
+{
+    int count;
+    double *x;
+    double *prefix;
+    job_t job;  // правило, допуск и точность, которыми досчитываются неполные районы на краях запроса
+    int all_op; // шагов средних прямоугольников на район
+} area_index_t;
+
+// Сохраняет индекс по count смежным интервалам, отсортированным по левой границе.
+// all_op - число шагов на район, с которым они посчитаны.
+int index_save(const char *path, const job_t *job, int all_op, const interval_t *items, int count);
+
+// Загружает индекс и выставляет профиль реки, с которым он был посчитан
+int index_load(const char *path, area_index_t *index);
+
+// Площадь на [c, d] внутри участка за O(log n)
+double index_query(const area_index_t *index, double c, double d, long long *evals);
+
+void index_free(area_index_t *index);
+
+#endif
@@ -0,0 +1,25 @@
+#include <string.h>
+#include "backend.h"
+
+const backend_t *const backends[] = {
+    &backend_posix_named,
+    &backend_posix_unnamed,
+    &backend_sysv,
+    &backend_futex,
+    &backend_eventfd,
+    &backend_pipe,
+    &backend_mqueue,
+    NULL,
+};
+
+const backend_t *backend_find(const char *name)
+{
+    for (int i = 0; backends[i] != NULL; i++)
+    {
+        if (strcmp(backends[i]->name, name) == 0)
+        {
+            return backends[i];
+        }
+    }
+    return NULL;
+}
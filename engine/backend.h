@@ -0,0 +1,44 @@
+#ifndef BACKEND_H
+#define BACKEND_H
+
+#include <stdbool.h>
+
+// Способ, которым счетоводы складывают площадь в общую сумму.
+// Агроном вызывает init до fork и cleanup в самом конце,
+// счетовод после fork вызывает attach (если есть) и add.
+typedef struct
+{
+    const char *name;
+    const char *description;
+    // Создание общей суммы и примитивов синхронизации
+    int (*init)(int num_processes, bool huge);
+    // Подготовка в дочернем процессе сразу после fork
+    int (*attach)(void);
+    // Прибавить площадь района к общей сумме
+    int (*add)(double area);
+    // Дескриптор, по которому агроном узнает о пришедших площадях (для каналов и очередей).
+    // Вызывается агрономом после fork.
+    int (*channel)(void);
+    // Забрать пришедшие площади без ожидания: 0 - ждать дальше, 1 - канал закрыт, -1 - ошибка
+    int (*gather)(void);
+    // Итоговая сумма после завершения всех счетоводов
+    double (*result)(void);
+    // Удаление всех объектов IPC, должно быть безопасно из обработчика сигнала
+    void (*cleanup)(void);
+} backend_t;
+
+extern const backend_t backend_posix_named;
+extern const backend_t backend_posix_unnamed;
+extern const backend_t backend_sysv;
+extern const backend_t backend_futex;
+extern const backend_t backend_eventfd;
+extern const backend_t backend_pipe;
+extern const backend_t backend_mqueue;
+
+// Все бэкенды, последний элемент NULL
+extern const backend_t *const backends[];
+
+// Ищет бэкенд по имени, NULL если такого нет
+const backend_t *backend_find(const char *name);
+
+#endif
@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <mqueue.h>
+#include "backend.h"
+#include "trace.h"
+
+#define MQ_NAME "/mq_are_cool"
+
+// Площади не складываются в общей памяти, а пересылаются агроному сообщениями,
+// поэтому блокировка не нужна: сумму считает только агроном.
+static int fds[2] = {-1, -1};
+static mqd_t mq = (mqd_t)-1;
+static mqd_t reader = (mqd_t)-1; // неблокирующий дескриптор очереди только у агронома
+static double total;
+
+static int pipe_init(int num_processes, bool huge)
+{
+    total = 0.0;
+    if (pipe(fds) == -1)
+    {
+        perror("Ошибка при создании канала");
+        return -1;
+    }
+    return 0;
+}
+
+static int pipe_attach(void)
+{
+    close(fds[0]);
+    fds[0] = -1;
+    return 0;
+}
+
+static int pipe_add(double area)
+{
+    // Запись меньше PIPE_BUF атомарна, сообщения не перемешаются
+    if (write(fds[1], &area, sizeof(area)) != sizeof(area))
+    {
+        perror("Ошибка при записи в канал");
+        return -1;
+    }
+    return 0;
+}
+
+static int pipe_channel(void)
+{
+    close(fds[1]);
+    fds[1] = -1;
+    fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+    return fds[0];
+}
+
+static int pipe_gather(void)
+{
+    double area;
+    ssize_t got;
+    while ((got = read(fds[0], &area, sizeof(area))) == sizeof(area))
+    {
+        total += area;
+    }
+    // Канал закроется, когда последний счетовод завершится
+    if (got == 0)
+    {
+        return 1;
+    }
+    if (errno != EAGAIN)
+    {
+        perror("Ошибка при чтении из канала");
+        return -1;
+    }
+    return 0;
+}
+
+static double channel_result(void)
+{
+    return total;
+}
+
+static void pipe_cleanup(void)
+{
+    for (int i = 0; i < 2; i++)
+    {
+        if (fds[i] != -1)
+        {
+            close(fds[i]);
+            fds[i] = -1;
+        }
+    }
+}
+
+static int mqueue_init(int num_processes, bool huge)
+{
+    struct mq_attr attr = {0};
+    attr.mq_maxmsg = 10;
+    attr.mq_msgsize = sizeof(double);
+    total = 0.0;
+    mq_unlink(MQ_NAME);
+    if ((mq = mq_open(MQ_NAME, O_CREAT | O_EXCL | O_RDWR, 0666, &attr)) == (mqd_t)-1)
+    {
+        perror("Ошибка при создании очереди сообщений");
+        return -1;
+    }
+    return 0;
+}
+
+static int mqueue_add(double area)
+{
+    // Полная очередь заставляет счетовода ждать, пока агроном ее разберет
+    long long waited = trace_now();
+    if (mq_send(mq, (const char *)&area, sizeof(area), 0) == -1)
+    {
+        perror("Ошибка при отправке в очередь сообщений");
+        return -1;
+    }
+    trace_span("wait", waited);
+    return 0;
+}
+
+static int mqueue_channel(void)
+{
+    // Флаги дескриптора общие с детьми, поэтому для чтения без ожидания нужен свой
+    if ((reader = mq_open(MQ_NAME, O_RDONLY | O_NONBLOCK)) == (mqd_t)-1)
+    {
+        perror("Ошибка при открытии очереди сообщений");
+    }
+    return reader;
+}
+
+static int mqueue_gather(void)
+{
+    double area;
+    while (mq_receive(reader, (char *)&area, sizeof(area), NULL) == sizeof(area))
+    {
+        total += area;
+    }
+    if (errno != EAGAIN)
+    {
+        perror("Ошибка при чтении из очереди сообщений");
+        return -1;
+    }
+    return 0;
+}
+
+static void mqueue_cleanup(void)
+{
+    if (reader != (mqd_t)-1)
+    {
+        mq_close(reader);
+        reader = (mqd_t)-1;
+    }
+    if (mq != (mqd_t)-1)
+    {
+        mq_close(mq);
+        mq = (mqd_t)-1;
+    }
+    mq_unlink(MQ_NAME);
+}
+
+const backend_t backend_pipe = {
+    .name = "pipe",
+    .description = "площади пересылаются агроному через неименованный канал",
+    .init = pipe_init,
+    .attach = pipe_attach,
+    .add = pipe_add,
+    .channel = pipe_channel,
+    .gather = pipe_gather,
+    .result = channel_result,
+    .cleanup = pipe_cleanup,
+};
+
+const backend_t backend_mqueue = {
+    .name = "mqueue",
+    .description = "площади пересылаются агроному через очередь сообщений POSIX",
+    .init = mqueue_init,
+    .add = mqueue_add,
+    .channel = mqueue_channel,
+    .gather = mqueue_gather,
+    .result = channel_result,
+    .cleanup = mqueue_cleanup,
+};
@@ -0,0 +1,156 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <limits.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <linux/futex.h>
+#include "backend.h"
+#include "trace.h"
+#include "shared.h"
+
+typedef struct
+{
+    int lock; // 0 - свободно, 1 - занято, 2 - занято и есть ожидающие
+    double sum;
+} futex_area_t;
+
+static futex_area_t *shared_area = MAP_FAILED;
+static size_t shm_size;
+static int efd = -1;
+
+static int map_area(bool huge)
+{
+    shm_size = sizeof(futex_area_t);
+    if (huge)
+    {
+        shm_size = huge_round(shm_size);
+    }
+    if ((shared_area = anon_shared(shm_size, huge)) == MAP_FAILED)
+    {
+        perror("Ошибка при разметке общей памяти");
+        return -1;
+    }
+    shared_area->lock = 0;
+    shared_area->sum = 0.0;
+    return 0;
+}
+
+static void unmap_area(void)
+{
+    if (shared_area != MAP_FAILED)
+    {
+        munmap(shared_area, shm_size);
+        shared_area = MAP_FAILED;
+    }
+}
+
+static double area_result(void)
+{
+    return shared_area->sum;
+}
+
+// Мьютекс на futex без лишних системных вызовов, когда за него никто не борется
+static void futex_lock(int *lock)
+{
+    int c = 0;
+    if (__atomic_compare_exchange_n(lock, &c, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+        return;
+    }
+    if (c != 2)
+    {
+        c = __atomic_exchange_n(lock, 2, __ATOMIC_ACQUIRE);
+    }
+    while (c != 0)
+    {
+        syscall(SYS_futex, lock, FUTEX_WAIT, 2, NULL, NULL, 0);
+        c = __atomic_exchange_n(lock, 2, __ATOMIC_ACQUIRE);
+    }
+}
+
+static void futex_unlock(int *lock)
+{
+    if (__atomic_exchange_n(lock, 0, __ATOMIC_RELEASE) == 2)
+    {
+        syscall(SYS_futex, lock, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+static int futex_init(int num_processes, bool huge)
+{
+    return map_area(huge);
+}
+
+static int futex_add(double area)
+{
+    long long waited = trace_now();
+    futex_lock(&shared_area->lock);
+    trace_span("wait", waited);
+    shared_area->sum += area;
+    futex_unlock(&shared_area->lock);
+    return 0;
+}
+
+static int eventfd_init(int num_processes, bool huge)
+{
+    if (map_area(huge) == -1)
+    {
+        return -1;
+    }
+    // Счетчик eventfd в режиме семафора: read забирает единицу, write возвращает
+    if ((efd = eventfd(1, EFD_SEMAPHORE)) == -1)
+    {
+        perror("Ошибка при создании eventfd");
+        return -1;
+    }
+    return 0;
+}
+
+static int eventfd_add(double area)
+{
+    uint64_t token;
+    long long waited = trace_now();
+    if (read(efd, &token, sizeof(token)) != sizeof(token))
+    {
+        perror("Ошибка при ожидании eventfd");
+        return -1;
+    }
+    trace_span("wait", waited);
+    shared_area->sum += area;
+    token = 1;
+    if (write(efd, &token, sizeof(token)) != sizeof(token))
+    {
+        perror("Ошибка при освобождении eventfd");
+        return -1;
+    }
+    return 0;
+}
+
+static void eventfd_cleanup(void)
+{
+    if (efd != -1)
+    {
+        close(efd);
+        efd = -1;
+    }
+    unmap_area();
+}
+
+const backend_t backend_futex = {
+    .name = "futex",
+    .description = "мьютекс на futex в анонимной общей памяти",
+    .init = futex_init,
+    .add = futex_add,
+    .result = area_result,
+    .cleanup = unmap_area,
+};
+
+const backend_t backend_eventfd = {
+    .name = "eventfd",
+    .description = "eventfd в режиме семафора и анонимная общая память",
+    .init = eventfd_init,
+    .add = eventfd_add,
+    .result = area_result,
+    .cleanup = eventfd_cleanup,
+};
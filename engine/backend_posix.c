@@ -0,0 +1,149 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <semaphore.h>
+#include "backend.h"
+#include "trace.h"
+#include "shared.h"
+
+#define SHM_NAME "/shm_are_cool"
+#define SEM_NAME "/sem_are_cool"
+
+typedef struct
+{
+    sem_t sem; // используется только неименованным вариантом
+    double sum;
+} posix_area_t;
+
+static posix_area_t *shared_area = MAP_FAILED;
+static size_t shm_size;
+static sem_t *sem_area = SEM_FAILED;
+
+static int posix_map(int num_processes, bool huge)
+{
+    int fd_shm;
+    if ((fd_shm = shm_open(SHM_NAME, O_CREAT | O_RDWR, 0666)) == -1)
+    {
+        perror("Ошибка при создании shared memory");
+        return -1;
+    }
+    shm_size = sizeof(posix_area_t);
+    if (huge)
+    {
+        shm_size = huge_round(shm_size);
+    }
+    if (ftruncate(fd_shm, shm_size) == -1)
+    {
+        perror("Ошибка при изменении размера shared memory");
+        close(fd_shm);
+        return -1;
+    }
+    shared_area = map_shared(fd_shm, shm_size, huge);
+    close(fd_shm);
+    if (shared_area == MAP_FAILED)
+    {
+        perror("Ошибка при разметке shared memory");
+        return -1;
+    }
+    shared_area->sum = 0.0;
+    return 0;
+}
+
+static void posix_unmap(void)
+{
+    if (shared_area != MAP_FAILED)
+    {
+        munmap(shared_area, shm_size);
+        shared_area = MAP_FAILED;
+    }
+    shm_unlink(SHM_NAME);
+}
+
+static int named_init(int num_processes, bool huge)
+{
+    if (posix_map(num_processes, huge) == -1)
+    {
+        return -1;
+    }
+    sem_unlink(SEM_NAME);
+    if ((sem_area = sem_open(SEM_NAME, O_CREAT | O_EXCL, 0666, 1)) == SEM_FAILED)
+    {
+        perror("Ошибка при создании семафора!");
+        return -1;
+    }
+    return 0;
+}
+
+static int unnamed_init(int num_processes, bool huge)
+{
+    if (posix_map(num_processes, huge) == -1)
+    {
+        return -1;
+    }
+    if (sem_init(&shared_area->sem, 1, 1) == -1)
+    {
+        perror("Ошибка при иницализации семафора sem_init");
+        return -1;
+    }
+    sem_area = &shared_area->sem;
+    return 0;
+}
+
+static int posix_add(double area)
+{
+    long long waited = trace_now();
+    if (sem_wait(sem_area) == -1)
+    {
+        perror("Ошибка при ожидании семафора");
+        return -1;
+    }
+    trace_span("wait", waited);
+    shared_area->sum += area;
+    sem_post(sem_area);
+    return 0;
+}
+
+static double posix_result(void)
+{
+    return shared_area->sum;
+}
+
+static void named_cleanup(void)
+{
+    if (sem_area != SEM_FAILED)
+    {
+        sem_close(sem_area);
+        sem_area = SEM_FAILED;
+    }
+    sem_unlink(SEM_NAME);
+    posix_unmap();
+}
+
+static void unnamed_cleanup(void)
+{
+    if (sem_area != SEM_FAILED)
+    {
+        sem_destroy(sem_area);
+        sem_area = SEM_FAILED;
+    }
+    posix_unmap();
+}
+
+const backend_t backend_posix_named = {
+    .name = "posix-named",
+    .description = "именованный POSIX семафор и POSIX общая память (4 балла)",
+    .init = named_init,
+    .add = posix_add,
+    .result = posix_result,
+    .cleanup = named_cleanup,
+};
+
+const backend_t backend_posix_unnamed = {
+    .name = "posix-unnamed",
+    .description = "неименованный POSIX семафор в POSIX общей памяти (5 баллов)",
+    .init = unnamed_init,
+    .add = posix_add,
+    .result = posix_result,
+    .cleanup = unnamed_cleanup,
+};
@@ -0,0 +1,101 @@
+#include <stdio.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/sem.h>
+#include "backend.h"
+#include "trace.h"
+#include "shared.h"
+
+#define SEM_KEY 1234 // ключ для семафоров
+#define SHM_KEY 5678 // ключ для разделяемой памяти
+
+union semun
+{
+    int val;
+    struct semid_ds *buf;
+    unsigned short *array;
+};
+
+static int shmid = -1, semid = -1;         // идентификаторы разделяемой памяти и семафоров
+static double *shared_area = (double *)-1; // указатель на разделяемую память
+
+static int sysv_init(int num_processes, bool huge)
+{
+    union semun sem_args;
+    if ((semid = semget(SEM_KEY, 1, IPC_CREAT | 0666)) == -1)
+    {
+        perror("Ошибка при создании семафоров");
+        return -1;
+    }
+    sem_args.val = 1;
+    if (semctl(semid, 0, SETVAL, sem_args) == -1)
+    {
+        perror("Ошибка при инициализации семафоров");
+        return -1;
+    }
+    if ((shmid = get_shared(SHM_KEY, sizeof(double), huge)) == -1)
+    {
+        perror("Ошибка при создании разделяемой памяти");
+        return -1;
+    }
+    if ((shared_area = shmat(shmid, NULL, 0)) == (double *)-1)
+    {
+        perror("Ошибка при получении указателя на разделяемую память");
+        return -1;
+    }
+    *shared_area = 0.0;
+    return 0;
+}
+
+static int sysv_add(double area)
+{
+    struct sembuf sops = {0, -1, 0}; // уменьшаем значение семафора на 1
+    long long waited = trace_now();
+    if (semop(semid, &sops, 1) == -1)
+    {
+        perror("Ошибка при ожидании семафора");
+        return -1;
+    }
+    trace_span("wait", waited);
+    *shared_area += area;
+    sops.sem_op = 1;
+    if (semop(semid, &sops, 1) == -1)
+    {
+        perror("Ошибка при освобождении семафора");
+        return -1;
+    }
+    return 0;
+}
+
+static double sysv_result(void)
+{
+    return *shared_area;
+}
+
+static void sysv_cleanup(void)
+{
+    if (shared_area != (double *)-1)
+    {
+        shmdt(shared_area);
+        shared_area = (double *)-1;
+    }
+    if (shmid != -1)
+    {
+        shmctl(shmid, IPC_RMID, NULL);
+        shmid = -1;
+    }
+    if (semid != -1)
+    {
+        semctl(semid, 0, IPC_RMID);
+        semid = -1;
+    }
+}
+
+const backend_t backend_sysv = {
+    .name = "sysv",
+    .description = "семафор и общая память SYSTEM V (6 баллов)",
+    .init = sysv_init,
+    .add = sysv_add,
+    .result = sysv_result,
+    .cleanup = sysv_cleanup,
+};
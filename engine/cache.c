@@ -0,0 +1,202 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <utime.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include "cache.h"
+
+#define STATS_NAME "stats"
+#define SUFFIX ".area"
+#define MAX_ENTRIES 65536
+
+// FNV-1a, чтобы имя файла определялось содержимым ключа
+static uint64_t hash_key(const char *key)
+{
+    uint64_t hash = 1469598103934665603ULL;
+    for (; *key != '\0'; key++)
+    {
+        hash ^= (unsigned char)*key;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void cache_open(cache_t *cache, const char *dir, long long limit, const job_t *job, int steps, int parts)
+{
+    char method[64];
+    cache->dir = dir;
+    cache->limit = limit;
+    job_method(job, method, sizeof(method));
+    snprintf(cache->key, sizeof(cache->key), "%s %s %.17g %d %d %.17g %.17g",
+             river.name, method, job->tol, steps, parts, job->a, job->b);
+    snprintf(cache->path, sizeof(cache->path), "%s/%016llx%s", dir, (unsigned long long)hash_key(cache->key), SUFFIX);
+    mkdir(dir, 0777);
+}
+
+// Прибавляет попадание или промах к статистике под блокировкой файла
+static void count(const cache_t *cache, bool hit)
+{
+    char path[4200];
+    long long hits = 0, misses = 0;
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s/%s", cache->dir, STATS_NAME);
+    if ((file = fopen(path, "a+")) == NULL)
+    {
+        return;
+    }
+    flock(fileno(file), LOCK_EX);
+    rewind(file);
+    if (fscanf(file, "%lld %lld", &hits, &misses) != 2)
+    {
+        hits = misses = 0;
+    }
+    if (hit)
+    {
+        hits++;
+    }
+    else
+    {
+        misses++;
+    }
+    if (ftruncate(fileno(file), 0) == 0)
+    {
+        fprintf(file, "%lld %lld\n", hits, misses);
+    }
+    fflush(file);
+    flock(fileno(file), LOCK_UN);
+    fclose(file);
+}
+
+bool cache_get(cache_t *cache, double *area)
+{
+    char key[sizeof(cache->key)];
+    FILE *file;
+    bool hit = false;
+
+    if ((file = fopen(cache->path, "r")) != NULL)
+    {
+        hit = fgets(key, sizeof(key), file) != NULL && strncmp(key, cache->key, strlen(cache->key)) == 0 &&
+              key[strlen(cache->key)] == '\n' && fscanf(file, "%lf", area) == 1;
+        fclose(file);
+    }
+    if (hit)
+    {
+        // Время изменения служит временем последнего использования для вытеснения
+        utime(cache->path, NULL);
+    }
+    count(cache, hit);
+    return hit;
+}
+
+typedef struct
+{
+    char name[256];
+    struct timespec used;
+    long long size;
+} entry_t;
+
+static int by_used(const void *left, const void *right)
+{
+    const struct timespec *l = &((const entry_t *)left)->used, *r = &((const entry_t *)right)->used;
+    if (l->tv_sec != r->tv_sec)
+    {
+        return (l->tv_sec > r->tv_sec) - (l->tv_sec < r->tv_sec);
+    }
+    return (l->tv_nsec > r->tv_nsec) - (l->tv_nsec < r->tv_nsec);
+}
+
+// Удаляет самые давно использованные ответы, пока каталог не влезет в лимит.
+// Только что записанный ответ не трогаем, даже если он один больше лимита.
+static void evict(const cache_t *cache)
+{
+    entry_t *entries = malloc(sizeof(entry_t) * MAX_ENTRIES);
+    char path[4400];
+    long long total = 0;
+    int count = 0;
+    struct dirent *item;
+    struct stat info;
+    DIR *dir;
+
+    if ((dir = opendir(cache->dir)) == NULL)
+    {
+        free(entries);
+        return;
+    }
+    while ((item = readdir(dir)) != NULL && count < MAX_ENTRIES)
+    {
+        size_t length = strlen(item->d_name);
+        if (length < strlen(SUFFIX) || strcmp(item->d_name + length - strlen(SUFFIX), SUFFIX) != 0)
+        {
+            continue;
+        }
+        snprintf(path, sizeof(path), "%s/%s", cache->dir, item->d_name);
+        if (stat(path, &info) == 0)
+        {
+            snprintf(entries[count].name, sizeof(entries[count].name), "%s", item->d_name);
+            entries[count].used = info.st_mtim;
+            entries[count].size = info.st_size;
+            total += info.st_size;
+            count++;
+        }
+    }
+    closedir(dir);
+    qsort(entries, count, sizeof(entry_t), by_used);
+    for (int i = 0; i < count && total > cache->limit; i++)
+    {
+        snprintf(path, sizeof(path), "%s/%s", cache->dir, entries[i].name);
+        if (strcmp(path, cache->path) != 0 && unlink(path) == 0)
+        {
+            total -= entries[i].size;
+        }
+    }
+    free(entries);
+}
+
+int cache_put(cache_t *cache, double area)
+{
+    char temp[4200];
+    FILE *file;
+
+    // Пишем во временный файл и переименовываем: читатель видит либо старый ответ, либо новый целиком
+    snprintf(temp, sizeof(temp), "%s.%d.tmp", cache->path, (int)getpid());
+    if ((file = fopen(temp, "w")) == NULL)
+    {
+        perror("Ошибка при записи в кэш");
+        return -1;
+    }
+    fprintf(file, "%s\n%.17g\n", cache->key, area);
+    if (fclose(file) != 0 || rename(temp, cache->path) == -1)
+    {
+        perror("Ошибка при записи в кэш");
+        unlink(temp);
+        return -1;
+    }
+    evict(cache);
+    return 0;
+}
+
+void cache_report(const cache_t *cache)
+{
+    char path[4200];
+    long long hits, misses;
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s/%s", cache->dir, STATS_NAME);
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        return;
+    }
+    if (fscanf(file, "%lld %lld", &hits, &misses) == 2 && hits + misses > 0)
+    {
+        printf("Кэш %s: попаданий %lld, промахов %lld (%.1f%%)\n",
+               cache->dir, hits, misses, 100.0 * hits / (hits + misses));
+    }
+    fclose(file);
+}
@@ -0,0 +1,32 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stdbool.h>
+#include "area.h"
+
+#define CACHE_LIMIT (64 * 1024 * 1024) // размер каталога кэша по умолчанию, байт
+
+// Кэш готовых ответов: файл на каждую комбинацию (профиль, правило, допуск, шаги, части, a, b).
+// Имя файла - хэш ключа, внутри сам ключ для проверки от коллизий.
+typedef struct
+{
+    const char *dir;
+    long long limit; // сколько байт могут занимать ответы, старые удаляются
+    char key[1200];
+    char path[4096];
+} cache_t;
+
+// Готовит ключ задания; steps - число шагов средних прямоугольников (0 для остальных правил),
+// parts - на сколько частей режется вся территория: от этого зависит площадь остальных правил
+void cache_open(cache_t *cache, const char *dir, long long limit, const job_t *job, int steps, int parts);
+
+// Ищет ответ, учитывая попадание или промах в статистике каталога
+bool cache_get(cache_t *cache, double *area);
+
+// Атомарно записывает ответ и вытесняет самые давно использованные
+int cache_put(cache_t *cache, double area);
+
+// Печатает статистику попаданий каталога
+void cache_report(const cache_t *cache);
+
+#endif
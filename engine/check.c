@@ -0,0 +1,359 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include <time.h>
+#include <unistd.h>
+#include "check.h"
+#include "area.h"
+#include "backend.h"
+#include "events.h"
+
+#define CHECK_STEPS 100000   // шагов средних прямоугольников для ядер точности
+#define CHECK_TOL 1e-9       // допуск адаптивного подсчета относительно площади
+#define CHECK_SLACK 10       // во сколько раз ошибка может превысить допуск
+#define CHECK_MIN_NS 5000000 // серия подсчетов не короче 5 мс, иначе время не измерить
+#define CHECK_BATCHES 5      // берется лучшая из серий
+#define CHECK_WORKERS 32     // счетоводов при проверке бэкенда
+#define CHECK_TIMEOUT_MS 10000
+#define MAX_METRICS 4096
+#define KEY_SIZE 160
+
+typedef struct
+{
+    char key[KEY_SIZE]; // файл/профиль/ядро/метрика
+    double value;
+} metric_t;
+
+static metric_t baseline_metrics[MAX_METRICS], fresh_metrics[MAX_METRICS];
+static int baseline_count, fresh_count;
+static bool verify; // сверять с эталоном, а не только записывать его
+static bool timing; // сверять и время, которое зависит от машины
+
+// Тестовые профили: как у агронома, крутой многочлен, колебания и ступенька на трети участка
+static const char *const profile_labels[] = {"default", "steep", "wave", "step", NULL};
+
+static void profile_spec(const char *label, double a, double b, char *spec, size_t size)
+{
+    if (strcmp(label, "steep") == 0)
+    {
+        snprintf(spec, size, "poly:1,0,0,0,0,0,0,0,1e-15");
+    }
+    else if (strcmp(label, "step") == 0)
+    {
+        snprintf(spec, size, "pw:-1e300,%.17g,0;%.17g,1e300,1", a + (b - a) / 3, a + (b - a) / 3);
+    }
+    else
+    {
+        snprintf(spec, size, "%s", label);
+    }
+}
+
+// Точная площадь: по кускам многочлена, а для wave - по первообразной 5x - 10 cos(x / 10)
+static bool reference_area(const profile_t *profile, double a, double b, double *area)
+{
+    if (profile_exact(profile, a, b, area))
+    {
+        return true;
+    }
+    if (strcmp(profile->name, "wave") == 0)
+    {
+        *area = 5.0 * (b - a) + 10.0 * (cos(a / 10.0) - cos(b / 10.0));
+        return true;
+    }
+    return false;
+}
+
+static int load_baseline(const char *path)
+{
+    FILE *file;
+    baseline_count = 0;
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        return -1;
+    }
+    while (baseline_count < MAX_METRICS &&
+           fscanf(file, "%159s %lf", baseline_metrics[baseline_count].key, &baseline_metrics[baseline_count].value) == 2)
+    {
+        baseline_count++;
+    }
+    fclose(file);
+    return 0;
+}
+
+static int save_baseline(const char *path)
+{
+    FILE *file;
+    if ((file = fopen(path, "w")) == NULL)
+    {
+        perror("Ошибка при открытии эталона");
+        return -1;
+    }
+    for (int i = 0; i < fresh_count; i++)
+    {
+        fprintf(file, "%s %.10g\n", fresh_metrics[i].key, fresh_metrics[i].value);
+    }
+    fclose(file);
+    return 0;
+}
+
+// Запоминает метрику и сверяет с эталоном: больше - хуже, floor - допустимое отставание
+// сверх доли threshold. Время (timed) сверяется только с --timing. Метрики нет в эталоне -
+// тоже регрессия. Возвращает 1 при регрессии и дописывает ее в note.
+static int compare(const char *key, double value, double threshold, double floor, bool timed, char *note,
+                   size_t size)
+{
+    size_t used = strlen(note);
+    if (fresh_count < MAX_METRICS)
+    {
+        snprintf(fresh_metrics[fresh_count].key, KEY_SIZE, "%s", key);
+        fresh_metrics[fresh_count++].value = value;
+    }
+    if (!verify || (timed && !timing))
+    {
+        return 0;
+    }
+    for (int i = 0; i < baseline_count; i++)
+    {
+        if (strcmp(baseline_metrics[i].key, key) != 0)
+        {
+            continue;
+        }
+        if (value > baseline_metrics[i].value * (1 + threshold) + floor)
+        {
+            snprintf(note + used, size - used, " %s: %.3g вместо %.3g;", strrchr(key, '/') + 1, value,
+                     baseline_metrics[i].value);
+            return 1;
+        }
+        return 0;
+    }
+    snprintf(note + used, size - used, " %s: нет в эталоне;", strrchr(key, '/') + 1);
+    return 1;
+}
+
+// Метрики эталона, которых не было в проверке: ядро, профиль или бэкенд пропали
+static int missing_metrics(void)
+{
+    int missing = 0, j;
+    for (int i = 0; i < baseline_count; i++)
+    {
+        for (j = 0; j < fresh_count && strcmp(fresh_metrics[j].key, baseline_metrics[i].key) != 0; j++)
+            ;
+        if (j == fresh_count)
+        {
+            printf("    %s РЕГРЕССИЯ: метрики эталона нет в проверке\n", baseline_metrics[i].key);
+            missing++;
+        }
+    }
+    return missing;
+}
+
+static double now_ns(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+// Ядро - адаптивное правило rule (если не NULL) или средние прямоугольники в точности precision
+static long double run_kernel(const rule_t *rule, const precision_t *precision, double tol, double a, double b,
+                              long long *evals)
+{
+    job_t job = {a, b, rule, tol, &precision_double};
+    if (rule != NULL)
+    {
+        return integrate_region(&job, a, b, 1, evals);
+    }
+    *evals += CHECK_STEPS;
+    return precision->midpoint(&river, a, b, CHECK_STEPS);
+}
+
+// Проверяет одно ядро: точность, вычисления f(x) и время на вычисление. Возвращает число регрессий.
+static int check_kernel(const char *prefix, const char *name, const rule_t *rule, const precision_t *precision,
+                        double a, double b, double exact, double threshold)
+{
+    double tol = CHECK_TOL * fmax(fabs(exact), DBL_MIN), best = INFINITY, started, error;
+    long long evals = 0, batch_evals;
+    long double area = run_kernel(rule, precision, tol, a, b, &evals);
+    char key[KEY_SIZE], note[512] = "";
+    int regressions = 0;
+
+    for (int batch = 0; batch < CHECK_BATCHES; batch++)
+    {
+        batch_evals = 0;
+        started = now_ns();
+        do
+        {
+            run_kernel(rule, precision, tol, a, b, &batch_evals);
+        } while (now_ns() - started < CHECK_MIN_NS);
+        best = fmin(best, (now_ns() - started) / batch_evals);
+    }
+    error = fabs((double)(area - exact));
+    // Сверх допуска прощается округление самих x: на участке шириной 1e-7 оно сравнимо с площадью
+    if (rule != NULL && error > CHECK_SLACK * tol + 4 * DBL_EPSILON * (fabs(a) + fabs(b)) * fabs(exact / (b - a)))
+    {
+        snprintf(note, sizeof(note), " ошибка больше допуска %.3g;", tol);
+        regressions++;
+    }
+    snprintf(key, sizeof(key), "%s/%s/evals", prefix, name);
+    regressions += compare(key, evals, threshold, 0, false, note, sizeof(note));
+    snprintf(key, sizeof(key), "%s/%s/ns", prefix, name);
+    regressions += compare(key, best, threshold, 1.0, true, note, sizeof(note));
+    snprintf(key, sizeof(key), "%s/%s/error", prefix, name);
+    regressions += compare(key, error, threshold, 1e-13 * fmax(fabs(exact), 1.0), false, note, sizeof(note));
+    printf("    %-20s вычислений %9lld %9.2f нс/выч  ошибка %10.3e  %s%s\n", name, evals, best, error,
+           regressions > 0 ? "РЕГРЕССИЯ:" : "ок", note);
+    return regressions;
+}
+
+// Один запуск бэкенда: CHECK_WORKERS счетоводов прибавляют точно представимые доли
+static int backend_once(const backend_t *backend, double *ns)
+{
+    double expected = 0.0, area, started = now_ns();
+    loop_t loop;
+    pid_t pid;
+    int result;
+
+    for (int i = 1; i <= CHECK_WORKERS; i++)
+    {
+        expected += i * 0.25;
+    }
+    if (backend->init(CHECK_WORKERS, false) == -1 || loop_init(&loop, CHECK_WORKERS) == -1)
+    {
+        backend->cleanup();
+        return -1;
+    }
+    fflush(stdout);
+    for (int i = 1; i <= CHECK_WORKERS; i++)
+    {
+        if ((pid = fork()) == -1)
+        {
+            perror("Ошибка при создании процесса!");
+            backend->cleanup();
+            return -1;
+        }
+        if (pid == 0)
+        {
+            if ((backend->attach != NULL && backend->attach() == -1) || backend->add(i * 0.25) == -1)
+            {
+                exit(1);
+            }
+            loop_notify(&loop, i);
+            exit(0);
+        }
+        loop_watch(&loop, i, pid);
+    }
+    if (backend->channel != NULL && loop_channel(&loop, backend->channel(), backend->gather) == -1)
+    {
+        backend->cleanup();
+        return -1;
+    }
+    result = loop_run(&loop, CHECK_TIMEOUT_MS);
+    area = backend->result();
+    result = result == 0 && loop.failed == 0 && loop.reported == CHECK_WORKERS && area == expected ? 0 : -1;
+    loop_free(&loop);
+    backend->cleanup();
+    *ns = now_ns() - started;
+    return result;
+}
+
+static int check_backend(const backend_t *backend, double threshold)
+{
+    double best = INFINITY, ns;
+    char key[KEY_SIZE], note[512] = "";
+    int regressions = 0;
+
+    for (int run = 0; run < CHECK_BATCHES; run++)
+    {
+        if (backend_once(backend, &ns) == -1)
+        {
+            printf("    %-20s РЕГРЕССИЯ: сумма %d счетоводов неверна\n", backend->name, CHECK_WORKERS);
+            return 1;
+        }
+        best = fmin(best, ns);
+    }
+    snprintf(key, sizeof(key), "backend/%s/us", backend->name);
+    regressions += compare(key, best / 1e3, threshold, 0, true, note, sizeof(note));
+    printf("    %-20s %d счетоводов за %9.1f мкс  %s%s\n", backend->name, CHECK_WORKERS, best / 1e3,
+           regressions > 0 ? "РЕГРЕССИЯ:" : "ок", note);
+    return regressions;
+}
+
+int check_run(const char *baseline, bool update, bool timed, double threshold, int count, char *args[])
+{
+    const char *file_name;
+    char spec[256], prefix[KEY_SIZE], name[64];
+    int regressions = 0;
+    double a, b, exact;
+    FILE *infile;
+
+    if (load_baseline(baseline) == -1 && !update)
+    {
+        printf("Эталона %s нет, только записываем его\n", baseline);
+        update = true;
+    }
+    verify = !update;
+    timing = timed;
+    printf("Проверка ядер: средние прямоугольники из %d шагов, допуск %.0e от площади, порог %.0f%%, время %s\n",
+           CHECK_STEPS, CHECK_TOL, threshold * 100, timing ? "сверяется" : "не сверяется (нужен --timing)");
+    for (int i = 0; i < count; i++)
+    {
+        if ((infile = fopen(args[i], "r")) == NULL)
+        {
+            perror("Ошибка при открытии входного файла!\n");
+            return -1;
+        }
+        if (fscanf(infile, "%lf %lf", &a, &b) != 2)
+        {
+            printf("Ошибка при чтении входных данных из %s\n", args[i]);
+            fclose(infile);
+            return -1;
+        }
+        fclose(infile);
+        file_name = strrchr(args[i], '/') != NULL ? strrchr(args[i], '/') + 1 : args[i];
+        printf("Участок %lf - %lf (%s)\n", a, b, file_name);
+        for (int p = 0; profile_labels[p] != NULL; p++)
+        {
+            profile_spec(profile_labels[p], a, b, spec, sizeof(spec));
+            if (profile_parse(spec, &river) == -1 || !reference_area(&river, a, b, &exact))
+            {
+                printf("  Профиль %s без точной площади, пропускаем\n", profile_labels[p]);
+                continue;
+            }
+            printf("  профиль %s, точная площадь %.10f\n", profile_labels[p], exact);
+            snprintf(prefix, sizeof(prefix), "%s/%s", file_name, profile_labels[p]);
+            for (int r = 0; rules[r] != NULL; r++)
+            {
+                regressions += check_kernel(prefix, rules[r]->name, rules[r], NULL, a, b, exact, threshold);
+            }
+            for (int k = 0; precisions[k] != NULL; k++)
+            {
+                snprintf(name, sizeof(name), "midpoint/%s", precisions[k]->name);
+                regressions += check_kernel(prefix, name, NULL, precisions[k], a, b, exact, threshold);
+            }
+        }
+    }
+    printf("Бэкенды:\n");
+    for (int i = 0; backends[i] != NULL; i++)
+    {
+        regressions += check_backend(backends[i], threshold);
+    }
+    if (verify)
+    {
+        regressions += missing_metrics();
+    }
+    if (update && save_baseline(baseline) == 0)
+    {
+        printf("Эталон (%d метрик) записан в %s\n", fresh_count, baseline);
+    }
+    else if (regressions > 0)
+    {
+        printf("Регрессий: %d\n", regressions);
+    }
+    else
+    {
+        printf("Регрессий нет\n");
+    }
+    return regressions;
+}
@@ -0,0 +1,14 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <stdbool.h>
+
+#define CHECK_THRESHOLD 0.5 // на сколько (доля) можно отстать от эталона без ошибки
+
+// Проверка ядер и бэкендов: площади по входным файлам count (файлы args) на тестовых профилях
+// сравниваются с точными, а вычисления f(x) и ошибка - с эталонным файлом baseline. Время на
+// вычисление и время бэкендов зависят от машины и сверяются только при timed. Метрика, которой
+// нет в эталоне или в проверке, - регрессия. При update эталон переписывается. Возвращает число регрессий.
+int check_run(const char *baseline, bool update, bool timed, double threshold, int count, char *args[]);
+
+#endif
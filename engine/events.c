@@ -0,0 +1,314 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "events.h"
+
+#define EVENT_BATCH 64
+
+// Что за дескриптор сработал: старшие 32 бита - вид, младшие - номер
+enum
+{
+    EVENT_SIGNAL,
+    EVENT_GROUP_READY,
+    EVENT_CHANNEL,
+    EVENT_EXIT
+};
+
+static uint64_t event_key(int kind, int index)
+{
+    return ((uint64_t)kind << 32) | (uint32_t)index;
+}
+
+static int epoll_add(int epoll, int fd, uint64_t key)
+{
+    struct epoll_event event = {.events = EPOLLIN, .data.u64 = key};
+    return epoll_ctl(epoll, EPOLL_CTL_ADD, fd, &event);
+}
+
+// На тысячи счетоводов дескрипторов по умолчанию может не хватить
+static void raise_fd_limit(int needed)
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < (rlim_t)needed)
+    {
+        limit.rlim_cur = limit.rlim_max < (rlim_t)needed ? limit.rlim_max : (rlim_t)needed;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+int loop_init(loop_t *loop, int count)
+{
+    loop->count = count;
+    loop->alive = 0;
+    loop->reported = 0;
+    loop->failed = 0;
+    loop->signal = -1;
+    loop->channel = -1;
+    loop->gather = NULL;
+    loop->tick_ms = 0;
+    loop->tick = NULL;
+    loop->group_count = (count + EVENT_GROUP - 1) / EVENT_GROUP;
+    loop->pidfds = malloc(sizeof(int) * count);
+    loop->groups = malloc(sizeof(int) * loop->group_count);
+    for (int i = 0; i < count; i++)
+    {
+        loop->pidfds[i] = -1;
+    }
+    raise_fd_limit(count + loop->group_count + 64);
+    if ((loop->epoll = epoll_create1(EPOLL_CLOEXEC)) == -1)
+    {
+        perror("Ошибка при создании epoll");
+        return -1;
+    }
+    for (int g = 0; g < loop->group_count; g++)
+    {
+        if ((loop->groups[g] = eventfd(0, EFD_NONBLOCK)) == -1 ||
+            epoll_add(loop->epoll, loop->groups[g], event_key(EVENT_GROUP_READY, g)) == -1)
+        {
+            perror("Ошибка при создании eventfd группы");
+            loop->group_count = g;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+void loop_notify(const loop_t *loop, int i)
+{
+    uint64_t one = 1;
+    if (write(loop->groups[(i - 1) / EVENT_GROUP], &one, sizeof(one)) != sizeof(one))
+    {
+        perror("Ошибка при записи в eventfd группы");
+    }
+}
+
+int loop_watch(loop_t *loop, int i, pid_t pid)
+{
+    int fd;
+    if ((fd = syscall(SYS_pidfd_open, pid, 0)) == -1)
+    {
+        perror("Ошибка при открытии pidfd");
+        return -1;
+    }
+    if (epoll_add(loop->epoll, fd, event_key(EVENT_EXIT, i)) == -1)
+    {
+        perror("Ошибка при добавлении pidfd в epoll");
+        close(fd);
+        return -1;
+    }
+    loop->pidfds[i - 1] = fd;
+    loop->alive++;
+    return 0;
+}
+
+int loop_channel(loop_t *loop, int fd, int (*gather)(void))
+{
+    if (fd == -1 || epoll_add(loop->epoll, fd, event_key(EVENT_CHANNEL, 0)) == -1)
+    {
+        perror("Ошибка при добавлении канала бэкенда в epoll");
+        return -1;
+    }
+    loop->channel = fd;
+    loop->gather = gather;
+    return 0;
+}
+
+void loop_every(loop_t *loop, int period_ms, void (*tick)(void *context), void *context)
+{
+    loop->tick_ms = period_ms;
+    loop->tick = tick;
+    loop->tick_context = context;
+}
+
+// Забирает площади из канала бэкенда. Закрытый канал больше не слушаем.
+static int gather_channel(loop_t *loop)
+{
+    int state = loop->gather();
+    if (state == 1)
+    {
+        epoll_ctl(loop->epoll, EPOLL_CTL_DEL, loop->channel, NULL);
+        loop->channel = -1;
+    }
+    return state == -1 ? -1 : 0;
+}
+
+// Забирает статус завершившегося процесса i
+static void reap(loop_t *loop, int i)
+{
+    siginfo_t info;
+    int fd = loop->pidfds[i - 1];
+
+    if (waitid(P_PIDFD, fd, &info, WEXITED) == 0 &&
+        (info.si_code != CLD_EXITED || info.si_status != 0))
+    {
+        printf("Процесс [%d] завершился с ошибкой (код %d)\n", i, info.si_status);
+        loop->failed++;
+    }
+    epoll_ctl(loop->epoll, EPOLL_CTL_DEL, fd, NULL);
+    close(fd);
+    loop->pidfds[i - 1] = -1;
+    loop->alive--;
+}
+
+static void drain_groups(loop_t *loop)
+{
+    uint64_t value;
+    for (int g = 0; g < loop->group_count; g++)
+    {
+        if (read(loop->groups[g], &value, sizeof(value)) == sizeof(value))
+        {
+            loop->reported += value;
+        }
+    }
+}
+
+static void kill_all(loop_t *loop)
+{
+    for (int i = 1; i <= loop->count; i++)
+    {
+        if (loop->pidfds[i - 1] != -1)
+        {
+            syscall(SYS_pidfd_send_signal, loop->pidfds[i - 1], SIGKILL, NULL, 0);
+            reap(loop, i);
+        }
+    }
+}
+
+static long remaining_ms(const struct timespec *deadline)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (deadline->tv_sec - now.tv_sec) * 1000 + (deadline->tv_nsec - now.tv_nsec) / 1000000;
+}
+
+static void deadline_after(struct timespec *deadline, int ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_sec += ms / 1000;
+    deadline->tv_nsec += (ms % 1000) * 1000000L;
+    if (deadline->tv_nsec >= 1000000000L)
+    {
+        deadline->tv_sec++;
+        deadline->tv_nsec -= 1000000000L;
+    }
+}
+
+int loop_run(loop_t *loop, int timeout_ms)
+{
+    struct epoll_event events[EVENT_BATCH];
+    struct signalfd_siginfo signal_info;
+    struct timespec deadline, next_tick;
+    sigset_t mask, old_mask;
+    int ready, result = 0;
+    long wait_ms, tick_wait;
+
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_BLOCK, &mask, &old_mask);
+    if ((loop->signal = signalfd(-1, &mask, SFD_CLOEXEC)) == -1 ||
+        epoll_add(loop->epoll, loop->signal, event_key(EVENT_SIGNAL, 0)) == -1)
+    {
+        perror("Ошибка при создании signalfd");
+        sigprocmask(SIG_SETMASK, &old_mask, NULL);
+        return -1;
+    }
+    deadline_after(&deadline, timeout_ms);
+    deadline_after(&next_tick, loop->tick_ms);
+
+    while (loop->alive > 0 && result == 0)
+    {
+        wait_ms = -1;
+        if (timeout_ms > 0 && (wait_ms = remaining_ms(&deadline)) <= 0)
+        {
+            printf("Счетоводы не уложились в %d мс, распускаем оставшихся (%d)\n", timeout_ms, loop->alive);
+            result = -1;
+            break;
+        }
+        if (loop->tick != NULL)
+        {
+            if ((tick_wait = remaining_ms(&next_tick)) <= 0)
+            {
+                loop->tick(loop->tick_context);
+                deadline_after(&next_tick, loop->tick_ms);
+                tick_wait = loop->tick_ms;
+            }
+            wait_ms = wait_ms == -1 || tick_wait < wait_ms ? tick_wait : wait_ms;
+        }
+        if ((ready = epoll_wait(loop->epoll, events, EVENT_BATCH, wait_ms)) == -1)
+        {
+            perror("Ошибка при ожидании событий");
+            result = -1;
+            break;
+        }
+        for (int e = 0; e < ready; e++)
+        {
+            int kind = events[e].data.u64 >> 32, index = (uint32_t)events[e].data.u64;
+            if (kind == EVENT_EXIT)
+            {
+                reap(loop, index);
+            }
+            else if (kind == EVENT_CHANNEL)
+            {
+                result = gather_channel(loop);
+            }
+            else if (kind == EVENT_GROUP_READY)
+            {
+                uint64_t value;
+                if (read(loop->groups[index], &value, sizeof(value)) == sizeof(value))
+                {
+                    loop->reported += value;
+                }
+            }
+            else if (read(loop->signal, &signal_info, sizeof(signal_info)) == sizeof(signal_info))
+            {
+                printf("\nАааааа, выпустите меня отсюда!!!! (сигнал %d)\n", signal_info.ssi_signo);
+                result = -1;
+            }
+        }
+    }
+    if (result == -1)
+    {
+        kill_all(loop);
+    }
+    // Процесс мог отчитаться и завершиться в одной пачке событий
+    drain_groups(loop);
+    if (result == 0 && loop->channel != -1)
+    {
+        result = gather_channel(loop);
+    }
+    sigprocmask(SIG_SETMASK, &old_mask, NULL);
+    return result;
+}
+
+void loop_free(loop_t *loop)
+{
+    for (int i = 0; i < loop->count; i++)
+    {
+        if (loop->pidfds[i] != -1)
+        {
+            close(loop->pidfds[i]);
+        }
+    }
+    for (int g = 0; g < loop->group_count; g++)
+    {
+        close(loop->groups[g]);
+    }
+    if (loop->signal != -1)
+    {
+        close(loop->signal);
+    }
+    close(loop->epoll);
+    free(loop->pidfds);
+    free(loop->groups);
+}
@@ -0,0 +1,51 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include <sys/types.h>
+
+#define EVENT_GROUP 64 // сколько процессов делят один eventfd для частичных сумм
+
+// Цикл событий агронома: один epoll на завершения процессов (pidfd),
+// готовые частичные суммы (eventfd на группу) и сигналы (signalfd)
+typedef struct
+{
+    int epoll;
+    int signal;
+    int count;       // сколько процессов ждем
+    int *pidfds;     // pidfd процесса i (с 1) в элементе i - 1
+    int *groups;     // eventfd группы процессов
+    int group_count;
+    int channel;     // канал бэкенда с площадями, -1 если его нет
+    int (*gather)(void);
+    int alive;       // сколько процессов еще не завершились
+    int reported;    // сколько частичных сумм пришло
+    int failed;      // сколько процессов завершились с ошибкой
+    int tick_ms;     // период вызова tick, 0 - не вызывать
+    void (*tick)(void *context);
+    void *tick_context;
+} loop_t;
+
+// Создает epoll и eventfd групп, вызывается до fork
+int loop_init(loop_t *loop, int count);
+
+// Сообщить агроному, что процесс i (с 1) отдал частичную сумму. Вызывается в дочернем процессе.
+void loop_notify(const loop_t *loop, int i);
+
+// Следить за завершением процесса i (с 1), вызывается агрономом после fork
+int loop_watch(loop_t *loop, int i, pid_t pid);
+
+// Забирать площади из канала бэкенда по мере готовности
+int loop_channel(loop_t *loop, int fd, int (*gather)(void));
+
+// Вызывать tick(context) каждые period_ms, пока идет loop_run. Из tick можно
+// создавать новые процессы и передавать их в loop_watch.
+void loop_every(loop_t *loop, int period_ms, void (*tick)(void *context), void *context);
+
+// Ждет всех процессов. SIGINT и SIGTERM с этого момента приходят через signalfd.
+// timeout_ms <= 0 - без ограничения. Возвращает 0, если все завершились,
+// -1 при сигнале или по таймауту (оставшиеся процессы к этому моменту убиты).
+int loop_run(loop_t *loop, int timeout_ms);
+
+void loop_free(loop_t *loop);
+
+#endif
@@ -0,0 +1,281 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/mman.h>
+#include "jobs.h"
+#include "shared.h"
+
+#define LINE_SIZE 256
+
+static long long now_ns(const job_queue_t *queue)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec - queue->start_ns;
+}
+
+int queue_load(FILE *infile, int units_per_job, bool fifo, job_queue_t *queue)
+{
+    queued_job_t parsed[MAX_JOBS];
+    char line[LINE_SIZE];
+    double deadline_ms, arrival_ms;
+    int fields;
+
+    memset(queue, 0, sizeof(*queue));
+    queue->fifo = fifo;
+    while (fgets(line, sizeof(line), infile) != NULL)
+    {
+        queued_job_t job = {0};
+        deadline_ms = arrival_ms = 0.0;
+        if ((fields = sscanf(line, "%lf %lf %d %lf %lf", &job.a, &job.b, &job.priority, &deadline_ms,
+                             &arrival_ms)) < 2)
+        {
+            continue; // пустая строка
+        }
+        if (queue->count == MAX_JOBS)
+        {
+            printf("Слишком много заданий, в очереди помещается не больше %d\n", MAX_JOBS);
+            return -1;
+        }
+        if (job.a < 0 || job.b < 0 || deadline_ms < 0 || arrival_ms < 0)
+        {
+            printf("Неправильное задание: %s", line);
+            return -1;
+        }
+        job.deadline_ns = deadline_ms * 1e6;
+        job.arrival_ns = arrival_ms * 1e6;
+        job.first = queue->units;
+        job.units = units_per_job;
+        queue->units += units_per_job;
+        parsed[queue->count++] = job;
+    }
+    if (queue->count == 0)
+    {
+        printf("В файле нет заданий\n");
+        return -1;
+    }
+    queue->jobs = anon_shared(sizeof(queued_job_t) * queue->count, false);
+    queue->areas = anon_shared(sizeof(double) * queue->units, false);
+    if (queue->jobs == MAP_FAILED || queue->areas == MAP_FAILED)
+    {
+        perror("Ошибка при разметке очереди заданий");
+        return -1;
+    }
+    memcpy(queue->jobs, parsed, sizeof(queued_job_t) * queue->count);
+    return 0;
+}
+
+// Абсолютный срок задания, без срока - бесконечность
+static double deadline_of(const queued_job_t *job)
+{
+    return job->deadline_ns > 0 ? (double)(job->arrival_ns + job->deadline_ns) : INFINITY;
+}
+
+// Срочнее: выше приоритет, раньше срок, раньше поступило. В fifo - только поступление.
+static bool more_urgent(const job_queue_t *queue, const queued_job_t *left, const queued_job_t *right)
+{
+    if (!queue->fifo && left->priority != right->priority)
+    {
+        return left->priority > right->priority;
+    }
+    if (!queue->fifo && deadline_of(left) != deadline_of(right))
+    {
+        return deadline_of(left) < deadline_of(right);
+    }
+    return left->arrival_ns < right->arrival_ns;
+}
+
+// Самое срочное из поступивших заданий с невзятыми частями. NULL - таких нет,
+// тогда в *wait_ns - сколько ждать следующего поступления (-1 - заданий больше не будет).
+static queued_job_t *queue_pick(job_queue_t *queue, long long now, long long *wait_ns)
+{
+    queued_job_t *best = NULL;
+    *wait_ns = -1;
+    for (int k = 0; k < queue->count; k++)
+    {
+        queued_job_t *job = &queue->jobs[k];
+        if (__atomic_load_n(&job->cursor, __ATOMIC_RELAXED) >= job->units)
+        {
+            continue;
+        }
+        if (job->arrival_ns > now)
+        {
+            *wait_ns = *wait_ns == -1 || job->arrival_ns - now < *wait_ns ? job->arrival_ns - now : *wait_ns;
+            continue;
+        }
+        if (best == NULL || more_urgent(queue, job, best))
+        {
+            best = job;
+        }
+    }
+    return best;
+}
+
+void queue_work(job_queue_t *queue, const job_t *template, int all_op)
+{
+    queued_job_t *queued;
+    job_t job = *template;
+    long long wait_ns, evals;
+    struct timespec pause;
+    double from, to;
+    int unit;
+
+    for (;;)
+    {
+        if ((queued = queue_pick(queue, now_ns(queue), &wait_ns)) == NULL)
+        {
+            if (wait_ns == -1)
+            {
+                return;
+            }
+            pause.tv_sec = wait_ns / 1000000000LL;
+            pause.tv_nsec = wait_ns % 1000000000LL;
+            nanosleep(&pause, NULL);
+            continue;
+        }
+        // После каждой части счетовод заново выбирает задание - так срочное вытесняет остальные
+        if ((unit = __atomic_fetch_add(&queued->cursor, 1, __ATOMIC_RELAXED)) >= queued->units)
+        {
+            continue;
+        }
+        job.a = queued->a;
+        job.b = queued->b;
+        evals = 0;
+        region_bounds(&job, unit + 1, queued->units, &from, &to);
+        queue->areas[queued->first + unit] = integrate_region(&job, from, to, all_op, &evals);
+        __atomic_fetch_add(&queued->evals, evals, __ATOMIC_RELAXED);
+        // Последняя посчитанная часть отмечает время готовности задания
+        if (__atomic_add_fetch(&queued->done, 1, __ATOMIC_ACQ_REL) == queued->units)
+        {
+            __atomic_store_n(&queued->finished_ns, now_ns(queue), __ATOMIC_RELEASE);
+        }
+    }
+}
+
+static int compare_latency(const void *left, const void *right)
+{
+    double l = *(const double *)left, r = *(const double *)right;
+    return (l > r) - (l < r);
+}
+
+// Процентиль p отсортированных задержек по ближайшему рангу
+static double percentile(const double *sorted, int count, double p)
+{
+    int rank = (int)ceil(p / 100.0 * count);
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+// Задание посчитано целиком: его части не пропали вместе с упавшим счетоводом
+static bool job_finished(const queued_job_t *job)
+{
+    return job->done == job->units && job->finished_ns > 0;
+}
+
+// Процентили задержек посчитанных заданий с приоритетом priority, при all - всех
+static void report_class(const job_queue_t *queue, int priority, bool all)
+{
+    double latencies[MAX_JOBS];
+    int count = 0, missed = 0, failed = 0;
+    for (int k = 0; k < queue->count; k++)
+    {
+        const queued_job_t *job = &queue->jobs[k];
+        if (!all && job->priority != priority)
+        {
+            continue;
+        }
+        if (!job_finished(job))
+        {
+            failed++;
+            continue;
+        }
+        latencies[count++] = (job->finished_ns - job->arrival_ns) / 1e6;
+        missed += job->deadline_ns > 0 && job->finished_ns - job->arrival_ns > job->deadline_ns;
+    }
+    qsort(latencies, count, sizeof(double), compare_latency);
+    if (all)
+    {
+        printf("Все задания: ");
+    }
+    else
+    {
+        printf("Приоритет %d: ", priority);
+    }
+    if (count == 0)
+    {
+        printf("заданий 0, не посчитано %d\n", failed);
+        return;
+    }
+    printf("заданий %d, задержка p50 %.3f мс, p90 %.3f мс, p99 %.3f мс, наибольшая %.3f мс, сорвано сроков %d, "
+           "не посчитано %d\n",
+           count, percentile(latencies, count, 50), percentile(latencies, count, 90),
+           percentile(latencies, count, 99), latencies[count - 1], missed, failed);
+}
+
+int queue_report(const job_queue_t *queue, FILE *outfile)
+{
+    int priorities[MAX_JOBS], classes = 0, failed = 0, j;
+    for (int k = 0; k < queue->count; k++)
+    {
+        const queued_job_t *job = &queue->jobs[k];
+        double area = 0.0, latency = (job->finished_ns - job->arrival_ns) / 1e6;
+        for (int unit = 0; unit < job->units; unit++)
+        {
+            area += queue->areas[job->first + unit];
+        }
+        for (j = 0; j < classes && priorities[j] != job->priority; j++)
+            ;
+        if (j == classes)
+        {
+            priorities[classes++] = job->priority;
+        }
+        if (!job_finished(job))
+        {
+            // Неполная площадь не выдается за ответ
+            fprintf(outfile, "Задание [%d] %lf - %lf, приоритет %d: не посчитано, готово частей %d из %d\n", k + 1,
+                    job->a, job->b, job->priority, job->done, job->units);
+            printf("Задание [%d] %lf - %lf, приоритет %d: не посчитано, готово частей %d из %d\n", k + 1, job->a,
+                   job->b, job->priority, job->done, job->units);
+            failed++;
+            continue;
+        }
+        fprintf(outfile, "Задание [%d] %lf - %lf, приоритет %d: площадь %.6f кв.м, вычислений f(x): %lld, задержка %.3f мс\n",
+                k + 1, job->a, job->b, job->priority, area, job->evals, latency);
+        printf("Задание [%d] %lf - %lf, приоритет %d: площадь %.6f кв.м, задержка %.3f мс", k + 1, job->a, job->b,
+               job->priority, area, latency);
+        if (job->deadline_ns > 0 && job->finished_ns - job->arrival_ns > job->deadline_ns)
+        {
+            printf(" (срок %.0f мс сорван)", job->deadline_ns / 1e6);
+        }
+        printf("\n");
+    }
+    // Приоритеты от срочных к остальным
+    for (int i = 0; i < classes; i++)
+    {
+        for (j = i + 1; j < classes; j++)
+        {
+            if (priorities[j] > priorities[i])
+            {
+                int swap = priorities[i];
+                priorities[i] = priorities[j];
+                priorities[j] = swap;
+            }
+        }
+        report_class(queue, priorities[i], false);
+    }
+    report_class(queue, 0, true);
+    return failed;
+}
+
+void queue_free(job_queue_t *queue)
+{
+    if (queue->jobs != NULL && queue->jobs != MAP_FAILED)
+    {
+        munmap(queue->jobs, sizeof(queued_job_t) * queue->count);
+    }
+    if (queue->areas != NULL && queue->areas != MAP_FAILED)
+    {
+        munmap(queue->areas, sizeof(double) * queue->units);
+    }
+}
@@ -0,0 +1,52 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include "area.h"
+
+#define MAX_JOBS 4096
+
+// Задание очереди в общей памяти
+typedef struct
+{
+    double a, b;
+    int priority;          // больше - срочнее
+    long long arrival_ns;  // когда задание поступает, от начала работы
+    long long deadline_ns; // срок от поступления, 0 - без срока
+    int first;             // первая часть задания в общем массиве площадей
+    int units;             // частей (районов) задания
+    int cursor;            // следующая не взятая часть
+    int done;              // посчитано частей
+    long long finished_ns; // когда посчитана последняя часть
+    long long evals;
+} queued_job_t;
+
+// Очередь заданий агронома на общих счетоводов
+typedef struct
+{
+    queued_job_t *jobs;
+    int count;
+    double *areas; // площади частей всех заданий
+    int units;     // всего частей
+    bool fifo;     // брать задания по порядку поступления, без приоритетов и сроков
+    long long start_ns;
+} job_queue_t;
+
+// Читает задания "a b [приоритет [срок_мс [поступление_мс]]]" по строке на задание
+// и режет каждое на units_per_job районов. Очередь размечается в общей памяти до fork.
+int queue_load(FILE *infile, int units_per_job, bool fifo, job_queue_t *queue);
+
+// Работа счетовода: пока в очереди есть части, берет часть самого срочного из поступивших
+// заданий и считает её. Срочное задание перехватывает счетоводов у остальных после
+// текущей части. all_op и шаблон template - как у одного задания.
+void queue_work(job_queue_t *queue, const job_t *template, int all_op);
+
+// Площади, задержки заданий и их процентили по приоритетам. Задания, части которых
+// не посчитаны (счетовод упал или распущен), отмечаются и в процентили не входят.
+// Возвращает число таких заданий.
+int queue_report(const job_queue_t *queue, FILE *outfile);
+
+void queue_free(job_queue_t *queue);
+
+#endif
@@ -0,0 +1,161 @@
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "libarea.h"
+#include "area.h"
+#include "placement.h"
+
+#define LIBAREA_UNITS 256 // частей территории с допуском, от числа потоков не зависит
+
+// Общее для потоков одного задания
+typedef struct
+{
+    const area_request_t *request;
+    job_t job;
+    int units;     // частей территории
+    int total;     // шагов (или панелей при tol = 0), которые делятся на части
+    int cursor;    // первая еще не взятая часть
+    double *areas; // площади частей, складываются по порядку после работы
+    double *errors;
+    long long evals;
+} work_t;
+
+struct area_task
+{
+    pthread_t thread;
+    area_request_t request;
+    area_result_t result;
+    area_done_t done;
+    void *context;
+};
+
+// Поток-счетовод: берет части из общего курсора, пока они не кончатся
+static void *work_thread(void *argument)
+{
+    work_t *work = argument;
+    const job_t *job = &work->job;
+    long long evals = 0;
+    int unit, first, last;
+    double from, to;
+
+    area_use(work->request->fn, work->request->context);
+    while ((unit = __atomic_fetch_add(&work->cursor, 1, __ATOMIC_RELAXED)) < work->units)
+    {
+        first = (long long)work->total * unit / work->units;
+        last = (long long)work->total * (unit + 1) / work->units;
+        from = job->a + (job->b - job->a) * first / work->total;
+        to = last == work->total ? job->b : job->a + (job->b - job->a) * last / work->total;
+        work->errors[unit] = 0.0;
+        // При tol = 0 средние прямоугольники режутся по шагам, остальные правила - по панелям
+        work->areas[unit] = integrate_region_estimate(job, from, to, job->rule == &rule_midpoint ? last - first : 1,
+                                                      &evals, &work->errors[unit]);
+    }
+    area_use(NULL, NULL);
+    __atomic_fetch_add(&work->evals, evals, __ATOMIC_RELAXED);
+    return NULL;
+}
+
+int area_integrate(const area_request_t *request, area_result_t *result)
+{
+    work_t work = {request};
+    pthread_t *threads;
+    int count = request->threads > 0 ? request->threads : usable_cpus(), started = 0;
+
+    memset(result, 0, sizeof(*result));
+    result->status = -1;
+    work.job.a = request->a;
+    work.job.b = request->b;
+    work.job.tol = request->tol > 0 ? request->tol : 0.0;
+    work.job.precision = &precision_double;
+    work.job.rule = request->rule != NULL ? rule_find(request->rule)
+                                          : (work.job.tol > 0 ? rule_find("gk15") : &rule_midpoint);
+    if (request->fn == NULL || work.job.rule == NULL || (work.job.tol == 0 && request->steps < 1))
+    {
+        return -1;
+    }
+    // Разбиение зависит только от задания, а потоки лишь разбирают части, поэтому площадь
+    // одна и та же при любом threads. С допуском территория режется на LIBAREA_UNITS частей,
+    // без него средние прямоугольники - по целым шагам, а остальные правила считают одну панель на часть
+    work.total = work.job.tol > 0 ? LIBAREA_UNITS : request->steps;
+    work.units = work.total < LIBAREA_UNITS ? work.total : LIBAREA_UNITS;
+    if (work.job.tol == 0 && work.job.rule != &rule_midpoint)
+    {
+        work.units = work.total;
+    }
+    count = count < work.units ? count : work.units;
+    work.areas = malloc(sizeof(double) * work.units);
+    work.errors = malloc(sizeof(double) * work.units);
+    threads = malloc(sizeof(pthread_t) * count);
+    if (work.areas == NULL || work.errors == NULL || threads == NULL)
+    {
+        free(work.areas);
+        free(work.errors);
+        free(threads);
+        return -1;
+    }
+    // Вызывающий поток считает сам, нанимаем только недостающих
+    while (started < count - 1 && pthread_create(&threads[started], NULL, work_thread, &work) == 0)
+    {
+        started++;
+    }
+    work_thread(&work);
+    for (int i = 0; i < started; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    // Части складываются по порядку, поэтому площадь не зависит от числа потоков
+    for (int unit = 0; unit < work.units; unit++)
+    {
+        result->area += work.areas[unit];
+        result->error += work.errors[unit];
+    }
+    result->evals = work.evals;
+    result->status = 0;
+    free(work.areas);
+    free(work.errors);
+    free(threads);
+    return 0;
+}
+
+static void *task_thread(void *argument)
+{
+    area_task_t *task = argument;
+    area_integrate(&task->request, &task->result);
+    if (task->done != NULL)
+    {
+        task->done(&task->result, task->context);
+    }
+    return NULL;
+}
+
+area_task_t *area_submit(const area_request_t *request, area_done_t done, void *context)
+{
+    area_task_t *task = malloc(sizeof(area_task_t));
+    if (task == NULL)
+    {
+        return NULL;
+    }
+    task->request = *request;
+    task->done = done;
+    task->context = context;
+    if (pthread_create(&task->thread, NULL, task_thread, task) != 0)
+    {
+        free(task);
+        return NULL;
+    }
+    return task;
+}
+
+int area_wait(area_task_t *task, area_result_t *result)
+{
+    int status;
+    pthread_join(task->thread, NULL);
+    status = task->result.status;
+    if (result != NULL)
+    {
+        *result = task->result;
+    }
+    free(task);
+    return status;
+}
@@ -0,0 +1,48 @@
+#ifndef LIBAREA_H
+#define LIBAREA_H
+
+// Публичный заголовок не тянет внутренние заголовки ядра (area.h, job_t, river и т.д.)
+
+// Функция реки f(x) с контекстом вызывающего
+typedef double (*area_fn_t)(double x, void *context);
+
+// Из libarea.so видны только функции с AREA_API, остальное ядро собирается с -fvisibility=hidden
+#define AREA_API __attribute__((visibility("default")))
+
+// Задание библиотеки: площадь под fn(x, context) на [a, b] без процессов и файлов
+typedef struct
+{
+    area_fn_t fn;
+    void *context;
+    double a, b;
+    double tol;       // допустимая ошибка, 0 - средние прямоугольники из steps шагов
+    int steps;        // шагов средних прямоугольников при tol = 0
+    int threads;      // потоков-счетоводов, 0 - по числу доступных ядер
+    const char *rule; // имя правила, NULL - gk15 при tol > 0 и midpoint иначе
+} area_request_t;
+
+typedef struct
+{
+    double area;
+    double error;    // оценка ошибки, NAN - правило её не дает
+    long long evals; // вычислений f(x)
+    int status;      // 0 - посчитано, -1 - неправильное задание или нет ресурсов
+} area_result_t;
+
+// Вызывается из потока задания, когда площадь посчитана
+typedef void (*area_done_t)(const area_result_t *result, void *context);
+
+typedef struct area_task area_task_t;
+
+// Считает площадь в потоках вызывающего процесса и ждет результата. Возвращает result->status.
+// fn вызывается из нескольких потоков сразу.
+AREA_API int area_integrate(const area_request_t *request, area_result_t *result);
+
+// Запускает подсчет в отдельном потоке и сразу возвращается. Когда площадь посчитана,
+// вызывает done (если не NULL). NULL - поток не создался.
+AREA_API area_task_t *area_submit(const area_request_t *request, area_done_t done, void *context);
+
+// Ждет задание из area_submit, копирует результат (если result не NULL) и освобождает задание
+AREA_API int area_wait(area_task_t *task, area_result_t *result);
+
+#endif
@@ -0,0 +1,1094 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <math.h>
+#include "area.h"
+#include "backend.h"
+#include "placement.h"
+#include "slots.h"
+#include "area_index.h"
+#include "plan.h"
+#include "store.h"
+#include "shared.h"
+#include "cache.h"
+#include "events.h"
+#include "trace.h"
+#include "results.h"
+#include "schedule.h"
+#include "check.h"
+#include "jobs.h"
+
+#define OVERSUBSCRIBE 4 // во сколько раз счетоводов может быть больше ядер без предупреждения
+#define TREE_FANOUT 32  // сколько счетоводов у одного помощника агронома по умолчанию
+#define ELASTIC_TICK_MS 10   // как часто агроном смотрит на остаток работы в режиме --elastic
+#define ELASTIC_TARGET_MS 20 // на сколько работы на каждого счетовода не стоит нанимать новых
+
+// Все, что счетоводу нужно знать о работе после fork
+typedef struct
+{
+    const interval_t *tasks;
+    region_record_t *records; // записи частей районов, schedule.pieces на интервал плана
+    schedule_t schedule;
+    int all_op;
+    bool by_steps; // части района режутся по шагам средних прямоугольников
+    const job_t *job;
+    bool pinned;
+    cpu_set_t cpus;
+} crew_t;
+
+// Состояние найма в режиме --elastic
+typedef struct
+{
+    const crew_t *crew;
+    int spawned;  // сколько счетоводов уже нанято
+    int capacity; // больше нанимать нельзя: под столько размечены ячейки и бэкенд
+} elastic_t;
+
+const backend_t *backend;
+slots_t slots;
+loop_t loop;
+
+void signal_handler(int signum)
+{
+    if (signum == SIGINT || signum == SIGTERM)
+    {
+        backend->cleanup();
+        slots_free(&slots);
+        printf("\nАааааа, выпустите меня отсюда!!!!\n");
+        exit(0);
+    }
+}
+
+void usage(const char *prog)
+{
+    printf("Использование: %s --query=ИНДЕКС c d [c d ...]\n", prog);
+    printf("       %s --bench-precision=ШАГОВ [--river=ПРОФИЛЬ] <входной файл> [...]\n", prog);
+    printf("       %s --check=ЭТАЛОН [--update] [--timing] [--threshold=ДОЛЯ] <входной файл> [...]\n", prog);
+    printf("       %s <входной файл> <выходной> <кол-во процессов|auto> [--backend=ИМЯ] [--hugetlb] [--pin[=ЯДРА]]\n", prog);
+    printf("       [--rule=ПРАВИЛО] [--tol=ДОПУСК] [--river=ПРОФИЛЬ] [--north=ПРОФИЛЬ] [--numeric] [--index=ФАЙЛ]\n");
+    printf("       [--store=ФАЙЛ] [--cache=КАТАЛОГ] [--cache-limit=БАЙТ] [--tree[=ГРУППА]]\n");
+    printf("       [--timeout=СЕК] [--trace=ФАЙЛ] [--precision=ТОЧНОСТЬ] [--records=ФАЙЛ] [--csv=ФАЙЛ]\n");
+    printf("       [--schedule=static|static,КУСОК|dynamic[,КУСОК]|guided[,КУСОК]] [--elastic[=НАИБОЛЬШЕЕ]]\n");
+    printf("       [--jobs[=fifo]] (во входном файле задания \"a b [приоритет [срок_мс [поступление_мс]]]\")\n");
+    printf("Доступные бэкенды:\n");
+    for (int i = 0; backends[i] != NULL; i++)
+    {
+        printf("  %-14s %s\n", backends[i]->name, backends[i]->description);
+    }
+    printf("Доступные правила:\n");
+    for (int i = 0; rules[i] != NULL; i++)
+    {
+        printf("  %-14s %s\n", rules[i]->name, rules[i]->description);
+    }
+    printf("Доступные точности (для midpoint без --tol):\n");
+    for (int i = 0; precisions[i] != NULL; i++)
+    {
+        printf("  %-14s %s\n", precisions[i]->name, precisions[i]->description);
+    }
+    printf("Профили реки: default (x * x / 1000), wave (5 + sin(x / 10)),\n");
+    printf("  poly:c0,c1,... (многочлен), pw:от,до,c0,c1,...;... (кусочный многочлен),\n");
+    printf("  bounds:СЕВЕР|РЕКА[|БЕРЕГ|БЕРЕГ...] (территория между кривыми)\n");
+}
+
+// Отвечает на запросы площадей участков [c, d] по сохраненному индексу
+int run_queries(const char *path, int count, char *bounds[])
+{
+    area_index_t index;
+    long long evals = 0;
+    if (count == 0 || count % 2 != 0)
+    {
+        printf("Запросы задаются парами границ c d\n");
+        return 1;
+    }
+    if (index_load(path, &index) == -1)
+    {
+        return 1;
+    }
+    printf("Индекс %s: %d районов от %lf до %lf, профиль %s\n",
+           path, index.count, index.x[0], index.x[index.count], river.name);
+    for (int i = 0; i < count; i += 2)
+    {
+        double c = atof(bounds[i]), d = atof(bounds[i + 1]);
+        printf("Площадь участка %lf - %lf: %.6f кв.м\n", c, d, index_query(&index, c, d, &evals));
+    }
+    printf("Вычислений f(x) на краях участков: %lld\n", evals);
+    index_free(&index);
+    return 0;
+}
+
+// Сравнивает точности ядра на участках из входных файлов
+int run_precision_bench(int steps, int count, char *args[])
+{
+    FILE *infile;
+    double a, b;
+    if (steps < 1)
+    {
+        printf("Число шагов должно быть положительным\n");
+        return 1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        if (strncmp(args[i], "--river=", 8) == 0)
+        {
+            if (profile_parse(args[i] + 8, &river) == -1)
+            {
+                printf("Неправильный профиль реки: %s\n", args[i] + 8);
+                return 1;
+            }
+            continue;
+        }
+        if ((infile = fopen(args[i], "r")) == NULL)
+        {
+            perror("Ошибка при открытии входного файла!\n");
+            return 1;
+        }
+        if (fscanf(infile, "%lf %lf", &a, &b) != 2)
+        {
+            printf("Ошибка при чтении входных данных из %s\n", args[i]);
+            fclose(infile);
+            return 1;
+        }
+        fclose(infile);
+        precision_bench(&river, a, b, steps);
+    }
+    return 0;
+}
+
+// Проверка ядер и бэкендов по эталону, 1 при регрессиях
+int run_check(const char *baseline, int count, char *args[])
+{
+    double threshold = CHECK_THRESHOLD;
+    bool update = false, timed = false;
+    int files = 0;
+    for (int i = 0; i < count; i++)
+    {
+        if (strcmp(args[i], "--update") == 0)
+        {
+            update = true;
+        }
+        else if (strcmp(args[i], "--timing") == 0)
+        {
+            timed = true;
+        }
+        else if (strncmp(args[i], "--threshold=", 12) == 0)
+        {
+            threshold = atof(args[i] + 12);
+        }
+        else
+        {
+            args[files++] = args[i];
+        }
+    }
+    if (files == 0 || threshold <= 0)
+    {
+        printf("Нужны входные файлы и положительный порог\n");
+        return 1;
+    }
+    return check_run(baseline, update, timed, threshold, files, args) != 0;
+}
+
+double elapsed_ms(const struct timespec *from)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - from->tv_sec) * 1e3 + (now.tv_nsec - from->tv_nsec) / 1e6;
+}
+
+// Параметры, которые понимает очередь заданий; остальные относятся к одному заданию
+bool queue_option(const char *arg)
+{
+    static const char *const supported[] = {"--jobs", "--rule=", "--precision=", "--tol=", "--river=",
+                                            "--north=", "--timeout=", NULL};
+    for (int i = 0; supported[i] != NULL; i++)
+    {
+        if (strncmp(arg, supported[i], strlen(supported[i])) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Несколько заданий из входного файла на общих счетоводах, срочные вперед
+int run_jobs(FILE *infile, FILE *outfile, int num_processes, const job_t *job, bool fifo, int timeout_ms)
+{
+    job_queue_t queue;
+    struct timespec start;
+    loop_t loop;
+    int failed;
+    // Средние прямоугольники режутся на районы как в одном задании, остальные правила - мельче,
+    // чтобы срочное задание ждало освобождения счетовода не дольше одной небольшой части
+    int units = job->rule == &rule_midpoint && job->tol == 0 ? num_processes : num_processes * SCHEDULE_GRAIN;
+    pid_t pid;
+
+    if (queue_load(infile, units, fifo, &queue) == -1 || loop_init(&loop, num_processes) == -1)
+    {
+        queue_free(&queue);
+        return 1;
+    }
+    printf("Заданий в очереди: %d, частей на задание: %d, порядок: %s\n", queue.count, units,
+           fifo ? "по поступлению" : "приоритет, затем срок");
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    queue.start_ns = start.tv_sec * 1000000000LL + start.tv_nsec;
+    fflush(stdout);
+    fflush(outfile);
+    for (int i = 1; i <= num_processes; i++)
+    {
+        if ((pid = fork()) == -1)
+        {
+            perror("Ошибка при создании процесса!");
+            loop_free(&loop);
+            queue_free(&queue);
+            return 1;
+        }
+        if (pid == 0)
+        {
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            queue_work(&queue, job, num_processes);
+            loop_notify(&loop, i);
+            exit(0);
+        }
+        loop_watch(&loop, i, pid);
+    }
+    loop_run(&loop, timeout_ms);
+    if (loop.failed > 0 || loop.reported < num_processes)
+    {
+        fprintf(stderr, "Внимание: отработали %d из %d счетоводов!\n", loop.reported, num_processes);
+    }
+    loop_free(&loop);
+    failed = queue_report(&queue, outfile);
+    printf("Правило %s, время работы: %.3f мс\n", job->rule->name, elapsed_ms(&start));
+    queue_free(&queue);
+    return failed > 0 ? 1 : 0;
+}
+
+// Границы части unit: район плана unit / pieces, часть unit % pieces.
+// Для средних прямоугольников части режутся по шагам района, так что точки f(x) те же, что без деления.
+void unit_bounds(const crew_t *crew, int unit, double *from, double *to, int *steps)
+{
+    const interval_t *task = &crew->tasks[unit / crew->schedule.pieces];
+    int pieces = crew->schedule.pieces, piece = unit % pieces;
+    int total = crew->by_steps ? crew->all_op : pieces;
+    int first = (long long)total * piece / pieces, last = (long long)total * (piece + 1) / pieces;
+
+    *from = task->from + (task->to - task->from) * first / total;
+    *to = last == total ? task->to : task->from + (task->to - task->from) * last / total;
+    *steps = crew->by_steps ? last - first : crew->all_op;
+}
+
+// Работа счетовода i после fork. При report он сам прибавляет площадь к общей сумме,
+// иначе только оставляет её в своей ячейке для помощника агронома.
+// forked - момент перед fork, с него на шкале начинается счетовод.
+void accountant(const crew_t *crew, int i, bool report, long long forked)
+{
+    worker_slot_t *slot = slot_at(&slots, i);
+    int cpu = -1, state = 0, first, last, steps;
+    long long started;
+    double from, to;
+
+    sigset_t mask;
+
+    trace_as(i);
+    trace_span("fork", forked);
+    started = trace_now();
+    signal(SIGINT, SIG_DFL);
+    signal(SIGTERM, SIG_DFL);
+    // Нанятые во время loop_run наследуют заблокированные агрономом сигналы
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGINT);
+    sigaddset(&mask, SIGTERM);
+    sigprocmask(SIG_UNBLOCK, &mask, NULL);
+    if (crew->pinned && (cpu = pin_worker(i, &crew->cpus)) == -1)
+    {
+        exit(1);
+    }
+    slot->cpu = cpu;
+    slot->node = current_node();
+    if (report && backend->attach != NULL && backend->attach() == -1)
+    {
+        exit(1);
+    }
+    trace_span("attach", started);
+    slot->evals = 0;
+    slot->area = 0.0;
+    // По умолчанию интервалы раздаются по кругу: счетовод i берёт i-й, (i + workers)-й и т.д.
+    while (schedule_next(&crew->schedule, i, &state, &first, &last))
+    {
+        for (int unit = first; unit < last; unit++)
+        {
+            started = trace_now();
+            unit_bounds(crew, unit, &from, &to, &steps);
+            slot->area += child_process(i, from, to, steps, crew->job, &crew->records[unit]);
+            slot->evals += crew->records[unit].evals;
+            schedule_done(&crew->schedule, crew->records[unit].nanos);
+            trace_region(started, from, to);
+        }
+    }
+    if (report)
+    {
+        started = trace_now();
+        if (backend->add(slot->area) == -1)
+        {
+            exit(1);
+        }
+        loop_notify(&loop, i);
+        trace_span("publish", started);
+    }
+    trace_mark("exit");
+    exit(0);
+}
+
+// Нанимает счетовода i, который сам отчитывается агроному
+int spawn_accountant(const crew_t *crew, int i)
+{
+    long long forked = trace_now();
+    pid_t pid;
+    // Иначе новый счетовод при выходе продублирует вывод агронома
+    fflush(stdout);
+    if ((pid = fork()) == -1)
+    {
+        perror("Ошибка при создании процесса!");
+        return -1;
+    }
+    if (pid == 0)
+    {
+        accountant(crew, i, true, forked);
+    }
+    return loop_watch(&loop, i, pid);
+}
+
+// Вызывается из цикла событий: если нерозданной работы на каждого счетовода больше
+// ELASTIC_TARGET_MS, нанимает еще (не больше, чем уже работает). Лишних увольнять не нужно:
+// когда части кончаются, свободный счетовод сам отчитывается и уходит.
+void elastic_tick(void *context)
+{
+    elastic_t *elastic = context;
+    const schedule_t *schedule = &elastic->crew->schedule;
+    int pending = schedule_pending(schedule), active = loop.alive, done, hire;
+    long long nanos;
+    double left_ms;
+
+    done = __atomic_load_n(&schedule->progress->done, __ATOMIC_RELAXED);
+    nanos = __atomic_load_n(&schedule->progress->nanos, __ATOMIC_RELAXED);
+    // Пока не посчитано ни одной части, скорость неизвестна
+    if (done == 0 || active == 0 || pending <= active || elastic->spawned >= elastic->capacity)
+    {
+        return;
+    }
+    left_ms = (double)pending * nanos / done / active / 1e6;
+    if (left_ms < ELASTIC_TARGET_MS)
+    {
+        return;
+    }
+    hire = active;
+    hire = hire < elastic->capacity - elastic->spawned ? hire : elastic->capacity - elastic->spawned;
+    hire = hire < pending - active ? hire : pending - active;
+    printf("Осталось частей %d, это ~%.0f мс на каждого из %d счетоводов: нанимаем еще %d\n",
+           pending, left_ms, active, hire);
+    for (int k = 0; k < hire; k++)
+    {
+        if (spawn_accountant(elastic->crew, elastic->spawned + 1) == -1)
+        {
+            return;
+        }
+        elastic->spawned++;
+    }
+}
+
+// Делит счетоводов first..last на не более чем fanout групп подряд.
+// Возвращает число групп, размер группы пишет в size.
+int split_groups(int first, int last, int fanout, int *size)
+{
+    int count = last - first + 1;
+    *size = (count + fanout - 1) / fanout;
+    return (count + *size - 1) / *size;
+}
+
+// Процесс помощника умер (например, его убил агроном по таймауту) - умираем вслед за ним,
+// а не считаем дальше сиротой
+void follow_parent(pid_t parent)
+{
+    if (prctl(PR_SET_PDEATHSIG, SIGKILL) == -1 || getppid() != parent)
+    {
+        exit(1);
+    }
+}
+
+// Помощник агронома над счетоводами first..last. Если их больше fanout,
+// нанимает помощников уровнем ниже. Сумму группы пишет в ячейку первого счетовода.
+void supervise(const crew_t *crew, int first, int last, int fanout)
+{
+    double sum = 0.0;
+    int size, groups;
+    pid_t pid, self = getpid();
+    long long forked, waited;
+
+    if (last - first + 1 <= fanout)
+    {
+        for (int i = first; i <= last; i++)
+        {
+            forked = trace_now();
+            if ((pid = fork()) == -1)
+            {
+                perror("Ошибка при создании процесса!");
+                exit(1);
+            }
+            if (pid == 0)
+            {
+                follow_parent(self);
+                accountant(crew, i, false, forked);
+            }
+        }
+        waited = trace_now();
+        while (wait(NULL) != -1)
+            ;
+        trace_span("wait children", waited);
+        for (int i = first; i <= last; i++)
+        {
+            sum += slot_at(&slots, i)->area;
+        }
+    }
+    else
+    {
+        groups = split_groups(first, last, fanout, &size);
+        for (int g = 0; g < groups; g++)
+        {
+            forked = trace_now();
+            if ((pid = fork()) == -1)
+            {
+                perror("Ошибка при создании процесса!");
+                exit(1);
+            }
+            if (pid == 0)
+            {
+                int from = first + g * size;
+                follow_parent(self);
+                trace_as(-from);
+                trace_span("fork", forked);
+                supervise(crew, from, from + size - 1 < last ? from + size - 1 : last, fanout);
+                trace_mark("exit");
+                exit(0);
+            }
+        }
+        waited = trace_now();
+        while (wait(NULL) != -1)
+            ;
+        trace_span("wait children", waited);
+        for (int g = 0; g < groups; g++)
+        {
+            sum += slot_at(&slots, first + g * size)->subtotal;
+        }
+    }
+    slot_at(&slots, first)->subtotal = sum;
+}
+
+int main(int argc, char *argv[])
+{
+    double answer = 0.0;
+    long long evals = 0;
+    interval_t *plan = NULL, *cached = NULL, *reused = NULL;
+    int task_count, workers, steps, pieces, max_pieces, cached_count, reused_count = 0, filled_count = 0;
+    const char *store_path = NULL, *cache_dir = NULL, *north_spec = NULL;
+    char bounds_spec[sizeof(river.name)];
+    long long cache_limit = CACHE_LIMIT;
+    cache_t cache;
+    job_t job = {0.0, 0.0, &rule_midpoint, 0.0, &precision_double};
+    FILE *infile, *outfile;
+    int num_processes, cpus_available, fanout = 0, reporters, group_size = 1, timeout_ms = 0, elastic_max = -1;
+    bool huge = false, pinned = false, numeric = false, exact, jobs = false, fifo = false, incomplete = false;
+    double exact_area;
+    const char *index_path = NULL, *trace_path = NULL, *records_path = NULL, *csv_path = NULL;
+    region_record_t *records = MAP_FAILED;
+    long long forked, waited;
+    crew_t crew;
+    elastic_t elastic = {&crew, 0, 0};
+    char schedule_text[64];
+    pid_t pid;
+    struct timespec start;
+
+    backend = &backend_posix_named;
+    schedule_parse("static", &crew.schedule);
+    profile_parse("default", &river);
+    if (argc >= 2 && strncmp(argv[1], "--query=", 8) == 0)
+    {
+        return run_queries(argv[1] + 8, argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strncmp(argv[1], "--bench-precision=", 18) == 0)
+    {
+        return run_precision_bench(atoi(argv[1] + 18), argc - 2, argv + 2);
+    }
+    if (argc >= 2 && strncmp(argv[1], "--check=", 8) == 0)
+    {
+        return run_check(argv[1] + 8, argc - 2, argv + 2);
+    }
+    if (argc < 4)
+    {
+        usage(argv[0]);
+        exit(1);
+    }
+    for (int i = 4; i < argc; i++)
+    {
+        if (strncmp(argv[i], "--backend=", 10) == 0)
+        {
+            if ((backend = backend_find(argv[i] + 10)) == NULL)
+            {
+                printf("Неизвестный бэкенд: %s\n", argv[i] + 10);
+                usage(argv[0]);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--rule=", 7) == 0)
+        {
+            if ((job.rule = rule_find(argv[i] + 7)) == NULL)
+            {
+                printf("Неизвестное правило: %s\n", argv[i] + 7);
+                usage(argv[0]);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--precision=", 12) == 0)
+        {
+            if ((job.precision = precision_find(argv[i] + 12)) == NULL)
+            {
+                printf("Неизвестная точность: %s\n", argv[i] + 12);
+                usage(argv[0]);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--tol=", 6) == 0)
+        {
+            job.tol = atof(argv[i] + 6);
+            if (job.tol <= 0)
+            {
+                printf("Допуск должен быть положительным: %s\n", argv[i] + 6);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--river=", 8) == 0)
+        {
+            if (profile_parse(argv[i] + 8, &river) == -1)
+            {
+                printf("Неправильный профиль реки: %s\n", argv[i] + 8);
+                usage(argv[0]);
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "--jobs=fifo") == 0)
+        {
+            jobs = true;
+            fifo = argv[i][6] == '=';
+        }
+        else if (strncmp(argv[i], "--north=", 8) == 0)
+        {
+            north_spec = argv[i] + 8;
+        }
+        else if (strcmp(argv[i], "--numeric") == 0)
+        {
+            numeric = true;
+        }
+        else if (strncmp(argv[i], "--index=", 8) == 0)
+        {
+            // Индекс строится по районам счетоводов, поэтому нужен численный подсчет
+            index_path = argv[i] + 8;
+            numeric = true;
+        }
+        else if (strncmp(argv[i], "--store=", 8) == 0)
+        {
+            // Хранилище интервалов имеет смысл только для численного подсчета
+            store_path = argv[i] + 8;
+            numeric = true;
+        }
+        else if (strncmp(argv[i], "--cache=", 8) == 0)
+        {
+            cache_dir = argv[i] + 8;
+        }
+        else if (strncmp(argv[i], "--cache-limit=", 14) == 0)
+        {
+            cache_limit = atoll(argv[i] + 14);
+        }
+        else if (strcmp(argv[i], "--tree") == 0 || strncmp(argv[i], "--tree=", 7) == 0)
+        {
+            fanout = argv[i][6] == '=' ? atoi(argv[i] + 7) : TREE_FANOUT;
+            if (fanout < 2)
+            {
+                printf("В группе должно быть хотя бы 2 счетовода: %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if (strcmp(argv[i], "--elastic") == 0 || strncmp(argv[i], "--elastic=", 10) == 0)
+        {
+            elastic_max = argv[i][9] == '=' ? atoi(argv[i] + 10) : 0;
+            if (elastic_max < 0 || (argv[i][9] == '=' && elastic_max == 0))
+            {
+                printf("Неправильное наибольшее число счетоводов: %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--timeout=", 10) == 0)
+        {
+            timeout_ms = atof(argv[i] + 10) * 1000;
+            if (timeout_ms <= 0)
+            {
+                printf("Таймаут должен быть положительным: %s\n", argv[i] + 10);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--schedule=", 11) == 0)
+        {
+            if (schedule_parse(argv[i] + 11, &crew.schedule) == -1)
+            {
+                printf("Неправильная политика раздачи: %s\n", argv[i] + 11);
+                usage(argv[0]);
+                exit(1);
+            }
+        }
+        else if (strncmp(argv[i], "--records=", 10) == 0)
+        {
+            records_path = argv[i] + 10;
+        }
+        else if (strncmp(argv[i], "--csv=", 6) == 0)
+        {
+            csv_path = argv[i] + 6;
+        }
+        else if (strncmp(argv[i], "--trace=", 8) == 0)
+        {
+            trace_path = argv[i] + 8;
+        }
+        else if (strcmp(argv[i], "--hugetlb") == 0)
+        {
+            huge = true;
+        }
+        else if (strcmp(argv[i], "--pin") == 0 || strncmp(argv[i], "--pin=", 6) == 0)
+        {
+            pinned = true;
+            if (parse_cpu_list(argv[i][5] == '=' ? argv[i] + 6 : "", &crew.cpus) == -1)
+            {
+                printf("Неправильный список ядер: %s\n", argv[i]);
+                exit(1);
+            }
+        }
+        else
+        {
+            printf("Неизвестный параметр: %s\n", argv[i]);
+            usage(argv[0]);
+            exit(1);
+        }
+    }
+    for (int i = 4; jobs && i < argc; i++)
+    {
+        if (!queue_option(argv[i]))
+        {
+            printf("Параметр %s не поддерживается вместе с --jobs\n", argv[i]);
+            exit(1);
+        }
+    }
+    if (job.precision != &precision_double && (job.rule != &rule_midpoint || job.tol > 0))
+    {
+        printf("Точность %s выбирается только для правила midpoint без --tol\n", job.precision->name);
+        exit(1);
+    }
+    // Кривая северная граница: территория между ней и рекой
+    if (north_spec != NULL)
+    {
+        if (snprintf(bounds_spec, sizeof(bounds_spec), "bounds:%s|%s", north_spec, river.name) >= (int)sizeof(bounds_spec) ||
+            profile_parse(bounds_spec, &river) == -1)
+        {
+            printf("Неправильная северная граница: %s\n", north_spec);
+            usage(argv[0]);
+            exit(1);
+        }
+    }
+    if ((infile = fopen(argv[1], "r")) == NULL)
+    {
+        perror("Ошибка при открытии входного файла!\n");
+        exit(1);
+    }
+    if ((outfile = fopen(argv[2], "w")) == NULL)
+    {
+        perror("Ошибка при открытии выходного файла!\n");
+        exit(1);
+    }
+
+    cpus_available = usable_cpus();
+    if (strcmp(argv[3], "auto") == 0)
+    {
+        num_processes = cpus_available;
+        printf("Доступно ядер: %d, нанимаем столько же счетоводов.\n", cpus_available);
+    }
+    else
+    {
+        num_processes = atoi(argv[3]);
+    }
+    printf("Агроном приказал %d счетоводам разделится и наконец посчитать площадь!\n", num_processes);
+    if (num_processes < 1)
+    {
+        printf("Неправильное кол-во процессов: %s\n", argv[3]);
+        exit(1);
+    }
+    if (num_processes > cpus_available * OVERSUBSCRIBE)
+    {
+        fprintf(stderr, "Внимание: %d счетоводов на %d доступных ядер, они будут мешать друг другу. Попробуйте auto.\n",
+                num_processes, cpus_available);
+    }
+    if (jobs)
+    {
+        int result = run_jobs(infile, outfile, num_processes, &job, fifo, timeout_ms);
+        fclose(outfile);
+        fclose(infile);
+        return result;
+    }
+    printf("Cчитываем входные данные...\n");
+    if (fscanf(infile, "%lf %lf", &job.a, &job.b) != 2)
+    {
+        printf("Ошибка при чтении входных данных, убедитесь, что в файле ввода только 2 double числа.\n");
+        exit(1);
+    }
+    if (job.a < 0 || job.b < 0)
+    {
+        printf("Ошибка при чтении входных данных, убедитесь, что числа неотрицательные!\n");
+        exit(1);
+    }
+    printf("Получили данные a = %lf, b= %lf.\n", job.a, job.b);
+
+    // Под многочленом площадь известна точно, счетоводов нанимать незачем
+    exact = profile_exact(&river, job.a, job.b, &exact_area);
+    if (exact && !numeric)
+    {
+        printf("Профиль %s - многочлен, считаем площадь точно.\n", river.name);
+        fprintf(outfile, "Агроном получил точную площадь: %.6f кв.м\n", exact_area);
+        printf("Агроном получил точную площадь: %.6f кв.м\nПодробнее в файле вывода %s\n", exact_area, argv[2]);
+        fclose(outfile);
+        fclose(infile);
+        return 0;
+    }
+
+    // Средние прямоугольники без уточнения можно делить на части только по целым шагам
+    crew.by_steps = job.rule == &rule_midpoint && job.tol == 0;
+    if (elastic_max >= 0)
+    {
+        // Нанимать по ходу можно только при раздаче из общего курсора, а без
+        // наибольшего числа счетоводов их столько, сколько задано в argv[3]
+        if (fanout > 0 || backend == &backend_pipe)
+        {
+            printf("Режим --elastic не работает с --tree и бэкендом pipe\n");
+            exit(1);
+        }
+        if (crew.schedule.kind == SCHEDULE_STATIC && crew.schedule.pieces > 1)
+        {
+            printf("Режим --elastic не работает с раздачей static,КУСОК\n");
+            exit(1);
+        }
+        if (crew.schedule.kind == SCHEDULE_STATIC)
+        {
+            schedule_parse("dynamic", &crew.schedule);
+        }
+        elastic_max = elastic_max > 0 ? elastic_max : num_processes;
+    }
+
+    steps = job.rule == &rule_midpoint && job.tol == 0 ? num_processes : 0;
+    // Остальные правила считают каждую часть района отдельно, поэтому площадь зависит от
+    // числа частей: разные раздачи не должны отдавать друг другу ответы из кэша и хранилища
+    max_pieces = crew.by_steps ? num_processes : SCHEDULE_GRAIN;
+    pieces = crew.schedule.pieces < max_pieces ? crew.schedule.pieces : max_pieces;
+    // Повторное задание отдаём из кэша, не нанимая счетоводов
+    if (cache_dir != NULL)
+    {
+        cache_open(&cache, cache_dir, cache_limit, &job, steps, num_processes * pieces);
+        if (cache_get(&cache, &answer))
+        {
+            fprintf(outfile, "Агроном нашел готовую площадь в кэше: %.6f кв.м\n", answer);
+            printf("Агроном нашел готовую площадь в кэше: %.6f кв.м\nПодробнее в файле вывода %s\n", answer, argv[2]);
+            cache_report(&cache);
+            fclose(outfile);
+            fclose(infile);
+            return 0;
+        }
+    }
+
+    // План работ: какие интервалы территории нужно посчитать
+    if (store_path != NULL)
+    {
+        if ((cached_count = store_load(store_path, &job, steps, pieces, &cached)) == -1)
+        {
+            exit(1);
+        }
+        task_count = plan_reuse(&job, cached, cached_count, fabs(job.b - job.a) / num_processes,
+                                &reused, &reused_count, &plan);
+        for (int k = 0; k < reused_count; k++)
+        {
+            answer += reused[k].area;
+        }
+        printf("Из хранилища %s взято %d интервалов, заново считаем %d\n", store_path, reused_count, task_count);
+        free(cached);
+    }
+    else
+    {
+        task_count = plan_static(&job, num_processes, &plan);
+    }
+    if ((workers = schedule_init(&crew.schedule, task_count, max_pieces,
+                                 elastic_max > 0 ? elastic_max : num_processes)) == -1)
+    {
+        exit(1);
+    }
+    // Сначала нанимаем по счетоводу на ядро, остальных - если работы окажется много
+    elastic.capacity = workers;
+    elastic.spawned = elastic_max > 0 && cpus_available < workers ? cpus_available : workers;
+    if (crew.schedule.pieces > 1 || crew.schedule.kind != SCHEDULE_STATIC)
+    {
+        printf("Раздача районов: %s, всего частей %d\n",
+               schedule_name(&crew.schedule, schedule_text, sizeof(schedule_text)), crew.schedule.units);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (workers > 0)
+    {
+        // В режиме дерева в общую сумму пишут только помощники агронома верхнего уровня
+        reporters = workers;
+        if (fanout > 0 && workers > fanout)
+        {
+            reporters = split_groups(1, workers, fanout, &group_size);
+            printf("Счетоводов %d, нанимаем %d помощников агронома по %d счетоводов\n", workers, reporters, group_size);
+        }
+        printf("Готовим бэкенд %s...\n", backend->name);
+        if (backend->init(reporters, huge) == -1)
+        {
+            backend->cleanup();
+            exit(1);
+        }
+        // Ячейки не трогаем до fork: страницу выделит ядро того узла, где работает счетовод
+        if (slots_init(&slots, workers, pinned, huge) == -1)
+        {
+            backend->cleanup();
+            exit(1);
+        }
+        // Счетоводы не пишут в файлы сами, а заполняют записи частей районов в общей памяти,
+        // по ним агроном потом собирает площади интервалов и пишет файлы
+        if ((records = anon_shared(sizeof(region_record_t) * crew.schedule.units, false)) == MAP_FAILED)
+        {
+            perror("Ошибка при разметке записей районов");
+            backend->cleanup();
+            exit(1);
+        }
+        crew.tasks = plan;
+        crew.records = records;
+        crew.all_op = num_processes;
+        crew.job = &job;
+        crew.pinned = pinned;
+        // На каждого счетовода и помощника: fork, attach, publish, wait, exit и по отрезку на район
+        if (trace_path != NULL && trace_open(crew.schedule.units + workers * 12 + 16) == -1)
+        {
+            backend->cleanup();
+            exit(1);
+        }
+        // eventfd групп нужны счетоводам, поэтому создаются до fork
+        if (loop_init(&loop, reporters) == -1)
+        {
+            backend->cleanup();
+            exit(1);
+        }
+        printf("Настраиваем хэндлер сигналов завершения...\n");
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+        // Буферы вывода сбрасываем до fork, иначе каждый счетовод их продублирует
+        fflush(stdout);
+        fflush(outfile);
+        printf("Создаём процессы...\n");
+        if (elastic_max > 0)
+        {
+            printf("Эластичный режим: нанимаем %d счетоводов из %d возможных\n", elastic.spawned, workers);
+            loop_every(&loop, ELASTIC_TICK_MS, elastic_tick, &elastic);
+        }
+        for (int i = 1; i <= elastic.spawned && reporters == workers; ++i)
+        {
+            if (spawn_accountant(&crew, i) == -1)
+            {
+                backend->cleanup();
+                exit(1);
+            }
+        }
+        for (int i = 1; i <= reporters && reporters != workers; ++i)
+        {
+            forked = trace_now();
+            pid = fork();
+            if (pid == -1)
+            {
+                perror("Ошибка при создании процесса!");
+                backend->cleanup();
+                exit(1);
+            }
+            if (pid > 0 && loop_watch(&loop, i, pid) == -1)
+            {
+                backend->cleanup();
+                exit(1);
+            }
+            if (pid == 0)
+            {
+                int first = 1 + (i - 1) * group_size;
+                int last = first + group_size - 1 < workers ? first + group_size - 1 : workers;
+                long long started;
+
+                trace_as(-first);
+                trace_span("fork", forked);
+                started = trace_now();
+                signal(SIGINT, SIG_DFL);
+                signal(SIGTERM, SIG_DFL);
+                if (backend->attach != NULL && backend->attach() == -1)
+                {
+                    exit(1);
+                }
+                trace_span("attach", started);
+                supervise(&crew, first, last, fanout);
+                started = trace_now();
+                if (backend->add(slot_at(&slots, first)->subtotal) == -1)
+                {
+                    exit(1);
+                }
+                loop_notify(&loop, i);
+                trace_span("publish", started);
+                trace_mark("exit");
+                exit(0);
+            }
+        }
+        if (backend->channel != NULL && loop_channel(&loop, backend->channel(), backend->gather) == -1)
+        {
+            backend->cleanup();
+            exit(1);
+        }
+        // Один поток ждет сразу завершений, частичных сумм, каналов, сигналов и таймаута
+        waited = trace_now();
+        if (loop_run(&loop, timeout_ms) == -1)
+        {
+            // По шкале прерванного запуска видно, кто не успел
+            if (trace_path != NULL && trace_save(trace_path) == 0)
+            {
+                printf("Временная шкала сохранена в %s\n", trace_path);
+            }
+            backend->cleanup();
+            slots_free(&slots);
+            exit(1);
+        }
+        if (reporters == workers)
+        {
+            // Дальше считаем только нанятых
+            reporters = workers = elastic.spawned;
+        }
+        if (elastic_max > 0)
+        {
+            printf("Эластичный режим: всего нанято счетоводов %d из %d\n", workers, elastic.capacity);
+        }
+        if (loop.failed > 0 || loop.reported < reporters)
+        {
+            // Неполную площадь нельзя отдавать из кэша следующим заданиям
+            fprintf(stderr, "Внимание: отчитались %d из %d, площадь неполная и не сохраняется!\n", loop.reported,
+                    reporters);
+            incomplete = true;
+        }
+        loop_free(&loop);
+        trace_span("wait accountants", waited);
+        answer += backend->result();
+        for (int i = 1; i <= workers; i++)
+        {
+            evals += slot_at(&slots, i)->evals;
+        }
+        // В хранилище и индекс идут только интервалы, все части которых посчитал счетовод
+        for (int k = 0; k < task_count; k++)
+        {
+            bool filled = true;
+            plan[k].area = 0.0;
+            for (int piece = 0; piece < crew.schedule.pieces; piece++)
+            {
+                plan[k].area += records[k * crew.schedule.pieces + piece].area;
+                filled = filled && records[k * crew.schedule.pieces + piece].worker != 0;
+            }
+            if (filled)
+            {
+                plan[filled_count++] = plan[k];
+            }
+        }
+        results_text(outfile, records, crew.schedule.units);
+        if (records_path != NULL && results_binary(records_path, &job, workers, records, crew.schedule.units) == 0)
+        {
+            printf("Записи районов (%d) сохранены в %s\n", crew.schedule.units, records_path);
+        }
+        if (csv_path != NULL && results_csv(csv_path, records, crew.schedule.units) == 0)
+        {
+            printf("Записи районов (%d) сохранены в %s\n", crew.schedule.units, csv_path);
+        }
+    }
+    // Хранилище хранит интервалы слева направо, а площадь при b < a, как и без хранилища, со знаком минус
+    if (store_path != NULL && job.b < job.a)
+    {
+        answer = -answer;
+    }
+    printf("Завершаем..\n");
+    fprintf(outfile, "Агроном и счетоводы получили общую площадь: %.6f кв.м\n", answer);
+    printf("Агроном и счетоводы получили общую площадь: %.6f кв.м\nПодробнее в файле вывода %s\n", answer, argv[2]);
+    printf("Бэкенд %s, правило %s, точность %s, вычислений f(x): %lld, время работы: %.3f мс\n",
+           backend->name, job.rule->name, job.precision->name, evals, elapsed_ms(&start));
+    if (exact)
+    {
+        // Точный ответ служит эталоном для численного подсчета
+        printf("Точная площадь: %.6f кв.м, ошибка счетоводов: %.3e кв.м\n", exact_area, answer - exact_area);
+    }
+    if (cache_dir != NULL && !incomplete && cache_put(&cache, answer) == 0)
+    {
+        cache_report(&cache);
+    }
+    if (store_path != NULL && !incomplete && filled_count > 0 &&
+        store_append(store_path, &job, steps, pieces, plan, filled_count) == 0)
+    {
+        printf("Новые интервалы (%d) дописаны в хранилище %s\n", filled_count, store_path);
+    }
+    // По неполному запуску индекс не строится: в нем были бы дыры
+    if (index_path != NULL && !incomplete)
+    {
+        // Индекс строится по всем интервалам территории, и старым, и новым
+        interval_t *all = malloc(sizeof(interval_t) * (reused_count + filled_count + 1));
+        memcpy(all, plan, sizeof(interval_t) * filled_count);
+        if (reused_count > 0)
+        {
+            memcpy(all + filled_count, reused, sizeof(interval_t) * reused_count);
+        }
+        plan_sort(all, reused_count + filled_count);
+        if (index_save(index_path, &job, num_processes, all, reused_count + filled_count) == 0)
+        {
+            printf("Индекс площадей сохранен в %s\n", index_path);
+        }
+        free(all);
+    }
+    if (pinned)
+    {
+        for (int i = 1; i <= workers; i++)
+        {
+            fprintf(outfile, "Счетовод [%d] работал на ядре %d, NUMA-узел %d\n",
+                    i, slot_at(&slots, i)->cpu, slot_at(&slots, i)->node);
+        }
+    }
+    if (trace_path != NULL && trace_save(trace_path) == 0)
+    {
+        printf("Временная шкала сохранена в %s, откройте её в chrome://tracing или ui.perfetto.dev\n", trace_path);
+    }
+    if (workers > 0)
+    {
+        backend->cleanup();
+        slots_free(&slots);
+        munmap(records, sizeof(region_record_t) * crew.schedule.units);
+        trace_close();
+    }
+    schedule_free(&crew.schedule);
+    free(plan);
+    free(reused);
+    fclose(outfile);
+    fclose(infile);
+    return incomplete ? 1 : 0;
+}
@@ -0,0 +1,156 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "placement.h"
+
+#define CGROUP_ROOT "/sys/fs/cgroup"
+#define PATH_SIZE 4096
+
+int parse_cpu_list(const char *list, cpu_set_t *set)
+{
+    char *end;
+    long from, to;
+
+    CPU_ZERO(set);
+    if (*list == '\0')
+    {
+        return sched_getaffinity(0, sizeof(cpu_set_t), set);
+    }
+    while (*list != '\0')
+    {
+        from = strtol(list, &end, 10);
+        if (end == list || from < 0)
+        {
+            return -1;
+        }
+        to = from;
+        if (*end == '-')
+        {
+            list = end + 1;
+            to = strtol(list, &end, 10);
+            if (end == list || to < from)
+            {
+                return -1;
+            }
+        }
+        if (to >= CPU_SETSIZE)
+        {
+            return -1;
+        }
+        for (long cpu = from; cpu <= to; cpu++)
+        {
+            CPU_SET(cpu, set);
+        }
+        if (*end == ',')
+        {
+            end++;
+        }
+        else if (*end != '\0')
+        {
+            return -1;
+        }
+        list = end;
+    }
+    return CPU_COUNT(set) > 0 ? 0 : -1;
+}
+
+int pin_worker(int i, const cpu_set_t *set)
+{
+    cpu_set_t one;
+    int skip = (i - 1) % CPU_COUNT(set);
+
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    {
+        if (!CPU_ISSET(cpu, set) || skip-- > 0)
+        {
+            continue;
+        }
+        CPU_ZERO(&one);
+        CPU_SET(cpu, &one);
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &one) == -1)
+        {
+            perror("Ошибка при привязке счетовода к ядру");
+            return -1;
+        }
+        return cpu;
+    }
+    return -1;
+}
+
+int current_node(void)
+{
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, NULL) == -1)
+    {
+        return -1;
+    }
+    return (int)node;
+}
+
+// Квота из файла cpu.max в ядрах (с округлением вверх), 0 если ограничения нет
+static int cgroup_quota(const char *dir)
+{
+    char path[PATH_SIZE + 64], quota[32];
+    long period;
+    FILE *file;
+    int cpus = 0;
+
+    snprintf(path, sizeof(path), "%s/cpu.max", dir);
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        return 0;
+    }
+    if (fscanf(file, "%31s %ld", quota, &period) == 2 && strcmp(quota, "max") != 0 && period > 0)
+    {
+        cpus = (int)((atol(quota) + period - 1) / period);
+    }
+    fclose(file);
+    return cpus;
+}
+
+int usable_cpus(void)
+{
+    char line[PATH_SIZE], dir[PATH_SIZE + 32];
+    cpu_set_t set;
+    FILE *file;
+    char *slash;
+    int cpus = 1, quota;
+
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &set) == 0)
+    {
+        cpus = CPU_COUNT(&set);
+    }
+    if ((file = fopen("/proc/self/cgroup", "r")) == NULL)
+    {
+        return cpus;
+    }
+    // В cgroup v2 у процесса одна строка вида "0::/путь"
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (strncmp(line, "0::", 3) != 0)
+        {
+            continue;
+        }
+        line[strcspn(line, "\n")] = '\0';
+        snprintf(dir, sizeof(dir), "%s%s", CGROUP_ROOT, strcmp(line + 3, "/") == 0 ? "" : line + 3);
+        // Квота родителя тоже ограничивает, поэтому поднимаемся до корня
+        while (strlen(dir) >= strlen(CGROUP_ROOT))
+        {
+            quota = cgroup_quota(dir);
+            if (quota > 0 && quota < cpus)
+            {
+                cpus = quota;
+            }
+            if ((slash = strrchr(dir, '/')) == NULL || strlen(dir) == strlen(CGROUP_ROOT))
+            {
+                break;
+            }
+            *slash = '\0';
+        }
+    }
+    fclose(file);
+    return cpus;
+}
@@ -0,0 +1,20 @@
+#ifndef PLACEMENT_H
+#define PLACEMENT_H
+
+#include <sched.h>
+
+// Разбирает список ядер вида "0-3,8,10-11", пустая строка - все доступные ядра
+int parse_cpu_list(const char *list, cpu_set_t *set);
+
+// Привязывает текущий процесс (счетовода i, с 1) к одному ядру набора по кругу.
+// Возвращает номер ядра или -1.
+int pin_worker(int i, const cpu_set_t *set);
+
+// NUMA-узел ядра, на котором сейчас выполняется процесс
+int current_node(void);
+
+// Сколько ядер реально доступно: маска sched_getaffinity,
+// урезанная квотой cpu.max из cgroup v2 (по всей цепочке родителей)
+int usable_cpus(void);
+
+#endif
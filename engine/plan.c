@@ -0,0 +1,80 @@
+#include <stdlib.h>
+#include <math.h>
+#include "plan.h"
+
+int plan_static(const job_t *job, int count, interval_t **out)
+{
+    *out = malloc(sizeof(interval_t) * count);
+    for (int i = 1; i <= count; i++)
+    {
+        region_bounds(job, i, count, &(*out)[i - 1].from, &(*out)[i - 1].to);
+        (*out)[i - 1].area = 0.0;
+    }
+    return count;
+}
+
+static int by_from(const void *left, const void *right)
+{
+    double l = ((const interval_t *)left)->from, r = ((const interval_t *)right)->from;
+    return (l > r) - (l < r);
+}
+
+void plan_sort(interval_t *items, int count)
+{
+    qsort(items, count, sizeof(interval_t), by_from);
+}
+
+// Режет дыру [from, to] на равные куски не шире width
+static void add_gap(double from, double to, double width, interval_t **fresh, int *count)
+{
+    int pieces = (int)ceil((to - from) / width);
+    if (pieces < 1)
+    {
+        pieces = 1;
+    }
+    *fresh = realloc(*fresh, sizeof(interval_t) * (*count + pieces));
+    for (int k = 0; k < pieces; k++)
+    {
+        (*fresh)[*count].from = from + (to - from) * k / pieces;
+        (*fresh)[*count].to = k + 1 == pieces ? to : from + (to - from) * (k + 1) / pieces;
+        (*fresh)[*count].area = 0.0;
+        (*count)++;
+    }
+}
+
+int plan_reuse(const job_t *job, const interval_t *cached, int cached_count, double width,
+               interval_t **reused, int *reused_count, interval_t **fresh)
+{
+    interval_t *sorted = malloc(sizeof(interval_t) * (cached_count > 0 ? cached_count : 1));
+    double x = fmin(job->a, job->b), end = fmax(job->a, job->b);
+    int count = 0;
+
+    *reused = malloc(sizeof(interval_t) * (cached_count > 0 ? cached_count : 1));
+    *reused_count = 0;
+    *fresh = NULL;
+    for (int i = 0; i < cached_count; i++)
+    {
+        sorted[i] = cached[i];
+    }
+    plan_sort(sorted, cached_count);
+    // Идём слева направо и берём первый известный интервал, который начинается не раньше x
+    for (int i = 0; i < cached_count; i++)
+    {
+        if (sorted[i].from < x || sorted[i].to > end || sorted[i].to <= sorted[i].from)
+        {
+            continue;
+        }
+        if (sorted[i].from > x)
+        {
+            add_gap(x, sorted[i].from, width, fresh, &count);
+        }
+        (*reused)[(*reused_count)++] = sorted[i];
+        x = sorted[i].to;
+    }
+    if (x < end)
+    {
+        add_gap(x, end, width, fresh, &count);
+    }
+    free(sorted);
+    return count;
+}
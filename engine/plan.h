@@ -0,0 +1,19 @@
+#ifndef PLAN_H
+#define PLAN_H
+
+#include "area.h"
+
+// Делит территорию задания на count равных районов, как раньше
+int plan_static(const job_t *job, int count, interval_t **out);
+
+// Накрывает [a, b] непересекающимися интервалами из cached (их площади уже известны),
+// всегда слева направо, даже при b < a: знак площади восстанавливает вызывающий.
+// а дыры между ними режет на куски не шире width, которые надо посчитать заново.
+// Возвращает число новых кусков в *fresh, уже известные интервалы попадают в *reused.
+int plan_reuse(const job_t *job, const interval_t *cached, int cached_count, double width,
+               interval_t **reused, int *reused_count, interval_t **fresh);
+
+// Сортирует интервалы по левой границе
+void plan_sort(interval_t *items, int count);
+
+#endif
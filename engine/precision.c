@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "precision.h"
+
+#define BENCH_RUNS 3 // берется лучший из запусков
+
+// Векторы GCC по 32 байта: во float помещается вдвое больше точек, чем в double.
+// Без AVX компилятор разбивает их на пары SSE-операций.
+typedef float vfloat __attribute__((vector_size(32)));
+typedef double vdouble __attribute__((vector_size(32)));
+
+// Ядро для типа T: точки одного куска профиля идут подряд, поэтому многочлен
+// считается схемой Горнера сразу для LANES точек вектора VEC.
+// Для long double и __float128 векторов нет, там VEC = T и LANES = 1.
+#define MIDPOINT_KERNEL(NAME, T, VEC, LANES)                                                     \
+    static T NAME##_piece(const piece_t *piece, T a, T h, int first, int last)                  \
+    {                                                                                             \
+        T coef[MAX_DEGREE + 1], lanes[LANES], sum = 0;                                            \
+        VEC acc = {0}, offset, x, y;                                                              \
+        int k = first;                                                                            \
+        for (int d = 0; d <= piece->degree; d++)                                                  \
+        {                                                                                         \
+            coef[d] = piece->coef[d];                                                             \
+        }                                                                                         \
+        for (int l = 0; l < LANES; l++)                                                           \
+        {                                                                                         \
+            lanes[l] = (T)l + (T)0.5;                                                             \
+        }                                                                                         \
+        memcpy(&offset, lanes, sizeof(offset));                                                   \
+        for (; k + LANES - 1 <= last; k += LANES)                                                 \
+        {                                                                                         \
+            x = a + ((T)k + offset) * h;                                                          \
+            y = x * 0 + coef[piece->degree];                                                      \
+            for (int d = piece->degree - 1; d >= 0; d--)                                          \
+            {                                                                                     \
+                y = y * x + coef[d];                                                              \
+            }                                                                                     \
+            acc += y;                                                                             \
+        }                                                                                         \
+        memcpy(lanes, &acc, sizeof(acc));                                                         \
+        for (int l = 0; l < LANES; l++)                                                           \
+        {                                                                                         \
+            sum += lanes[l];                                                                      \
+        }                                                                                         \
+        for (; k <= last; k++)                                                                    \
+        {                                                                                         \
+            T xs = a + ((T)k + (T)0.5) * h, ys = coef[piece->degree];                             \
+            for (int d = piece->degree - 1; d >= 0; d--)                                          \
+            {                                                                                     \
+                ys = ys * xs + coef[d];                                                           \
+            }                                                                                     \
+            sum += ys;                                                                            \
+        }                                                                                         \
+        return sum;                                                                               \
+    }                                                                                             \
+                                                                                                  \
+    static T NAME##_sum(const profile_t *profile, double from, double to, int steps)             \
+    {                                                                                             \
+        T a = from, h = ((T)to - a) / steps, total = 0;                                           \
+        int i = 0, p = 0, j;                                                                      \
+        if (to < from)                                                                            \
+        {                                                                                         \
+            return -NAME##_sum(profile, to, from, steps);                                         \
+        }                                                                                         \
+        /* Куски важнее fn: по ним многочлен считается в T и векторно (см. profile.h) */          \
+        if (profile->num_pieces == 0)                                                             \
+        {                                                                                         \
+            /* Профиль не многочлен: f(x) есть только в double, сумма все равно в T */            \
+            for (; i < steps; i++)                                                                \
+            {                                                                                     \
+                total += (T)profile->fn((double)(a + ((T)i + (T)0.5) * h));                       \
+            }                                                                                     \
+            return h * total;                                                                     \
+        }                                                                                         \
+        while (i < steps && p < profile->num_pieces)                                              \
+        {                                                                                         \
+            const piece_t *piece = &profile->pieces[p];                                           \
+            T x = a + ((T)i + (T)0.5) * h;                                                        \
+            if (x > (T)piece->to)                                                                 \
+            {                                                                                     \
+                p++;                                                                              \
+                continue;                                                                         \
+            }                                                                                     \
+            if (x < (T)piece->from)                                                               \
+            {                                                                                     \
+                i++; /* вне кусков f = 0 */                                                       \
+                continue;                                                                         \
+            }                                                                                     \
+            /* Последняя точка куска: оценка по формуле и поправка по самим точкам */            \
+            j = isinf(piece->to) ? steps - 1 : (int)fminl(steps - 1, fmaxl(i, floorl(((long double)piece->to - a) / h - 0.5L))); \
+            while (j + 1 < steps && a + ((T)(j + 1) + (T)0.5) * h <= (T)piece->to)                \
+            {                                                                                     \
+                j++;                                                                              \
+            }                                                                                     \
+            while (j > i && a + ((T)j + (T)0.5) * h > (T)piece->to)                               \
+            {                                                                                     \
+                j--;                                                                              \
+            }                                                                                     \
+            total += NAME##_piece(piece, a, h, i, j);                                             \
+            i = j + 1;                                                                            \
+        }                                                                                         \
+        return h * total;                                                                         \
+    }                                                                                             \
+                                                                                                  \
+    static long double NAME##_midpoint(const profile_t *profile, double a, double b, int steps)  \
+    {                                                                                             \
+        return NAME##_sum(profile, a, b, steps);                                                  \
+    }
+
+MIDPOINT_KERNEL(float32, float, vfloat, 8)
+MIDPOINT_KERNEL(float64, double, vdouble, 4)
+MIDPOINT_KERNEL(extended, long double, long double, 1)
+MIDPOINT_KERNEL(quad, __float128, __float128, 1)
+
+static const precision_t precision_float = {
+    .name = "float",
+    .description = "float, по 8 точек в векторе - быстрая грубая оценка",
+    .midpoint = float32_midpoint,
+};
+
+const precision_t precision_double = {
+    .name = "double",
+    .description = "double, по 4 точки в векторе (по умолчанию)",
+    .midpoint = float64_midpoint,
+};
+
+static const precision_t precision_long_double = {
+    .name = "long-double",
+    .description = "80-битный long double x87, без векторов",
+    .midpoint = extended_midpoint,
+};
+
+static const precision_t precision_quad = {
+    .name = "float128",
+    .description = "__float128 (binary128) программно - для справок кадастра",
+    .midpoint = quad_midpoint,
+};
+
+const precision_t *const precisions[] = {
+    &precision_float,
+    &precision_double,
+    &precision_long_double,
+    &precision_quad,
+    NULL,
+};
+
+const precision_t *precision_find(const char *name)
+{
+    for (int i = 0; precisions[i] != NULL; i++)
+    {
+        if (strcmp(precisions[i]->name, name) == 0)
+        {
+            return precisions[i];
+        }
+    }
+    return NULL;
+}
+
+// Точная площадь под кусками в __float128, NAN если профиль не многочлен
+static __float128 exact_quad(const profile_t *profile, double a, double b)
+{
+    __float128 area = 0, lo = a < b ? a : b, hi = a < b ? b : a;
+    if (profile->num_pieces == 0)
+    {
+        return NAN;
+    }
+    for (int p = 0; p < profile->num_pieces; p++)
+    {
+        const piece_t *piece = &profile->pieces[p];
+        __float128 from = piece->from > lo ? piece->from : lo, to = piece->to < hi ? piece->to : hi;
+        __float128 upper = 0, lower = 0;
+        if (from >= to)
+        {
+            continue;
+        }
+        for (int d = piece->degree; d >= 0; d--)
+        {
+            upper = upper * to + (__float128)piece->coef[d] / (d + 1);
+            lower = lower * from + (__float128)piece->coef[d] / (d + 1);
+        }
+        area += upper * to - lower * from;
+    }
+    return a < b ? area : -area;
+}
+
+static double seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+void precision_bench(const profile_t *profile, double a, double b, int steps)
+{
+    __float128 reference = quad_sum(profile, a, b, steps), exact = exact_quad(profile, a, b);
+    printf("Участок %lf - %lf, профиль %s, шагов %d\n", a, b, profile->name, steps);
+    // Ширина полей в байтах, а кириллица занимает по 2 байта на букву
+    printf("  %-20s %19s %22s %31s %22s %18s\n", "точность", "время, мс", "млн точек/с", "площадь", "округление", "ошибка");
+    for (int i = 0; precisions[i] != NULL; i++)
+    {
+        long double area = 0;
+        double best = INFINITY, started;
+        for (int run = 0; run < BENCH_RUNS; run++)
+        {
+            started = seconds();
+            area = precisions[i]->midpoint(profile, a, b, steps);
+            best = fmin(best, seconds() - started);
+        }
+        // Округление - отличие от той же суммы в __float128, ошибка - от точной площади
+        printf("  %-12s %12.3f %14.1f %24.15Lf %12.3Le %12.3Le\n", precisions[i]->name, best * 1e3,
+               steps / best / 1e6, area, (long double)(area - reference),
+               (long double)((__float128)area - exact));
+    }
+}
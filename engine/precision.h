@@ -0,0 +1,27 @@
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include "profile.h"
+
+// Ядро метода средних прямоугольников в заданной точности: точки, сумма
+// и многочлены профиля считаются в своем типе, наружу отдается long double.
+typedef struct
+{
+    const char *name;
+    const char *description;
+    long double (*midpoint)(const profile_t *profile, double a, double b, int steps);
+} precision_t;
+
+extern const precision_t precision_double;
+
+// Все точности, последний элемент NULL
+extern const precision_t *const precisions[];
+
+// Ищет точность по имени, NULL если такой нет
+const precision_t *precision_find(const char *name);
+
+// Сравнивает все точности на [a, b] из steps шагов: время, скорость и ошибка
+// относительно той же суммы в __float128 и точной площади
+void precision_bench(const profile_t *profile, double a, double b, int steps);
+
+#endif
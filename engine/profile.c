@@ -0,0 +1,313 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "profile.h"
+
+profile_t river;
+
+// Границы последнего разобранного профиля bounds:, которые нельзя слить в куски.
+// Функция профиля не получает контекста, поэтому такой профиль одновременно один.
+static profile_t bounds[MAX_BOUNDS];
+static int bounds_count;
+
+static double river_default(double x)
+{
+    return x * x / 1000.0;
+}
+
+static double river_wave(double x)
+{
+    return 5.0 + sin(x / 10.0);
+}
+
+static double horner(const piece_t *piece, double x)
+{
+    double y = 0.0;
+    for (int k = piece->degree; k >= 0; k--)
+    {
+        y = y * x + piece->coef[k];
+    }
+    return y;
+}
+
+// Первообразная куска с нулевой константой
+static double antiderivative(const piece_t *piece, double x)
+{
+    double y = 0.0;
+    for (int k = piece->degree; k >= 0; k--)
+    {
+        y = y * x + piece->coef[k] / (k + 1);
+    }
+    return y * x;
+}
+
+// Читает "from,to,c0,c1,..." или "c0,c1,..." до разделителя ';'
+static int parse_piece(const char *text, piece_t *piece, bool bounded)
+{
+    double values[MAX_DEGREE + 3];
+    int count = 0;
+    char *end;
+
+    while (*text != '\0' && *text != ';')
+    {
+        if (count == MAX_DEGREE + 3)
+        {
+            return -1;
+        }
+        values[count++] = strtod(text, &end);
+        if (end == text || (*end != ',' && *end != ';' && *end != '\0'))
+        {
+            return -1;
+        }
+        text = *end == ',' ? end + 1 : end;
+    }
+    int skip = bounded ? 2 : 0;
+    if (count <= skip || count - skip > MAX_DEGREE + 1)
+    {
+        return -1;
+    }
+    piece->from = bounded ? values[0] : -INFINITY;
+    piece->to = bounded ? values[1] : INFINITY;
+    piece->degree = count - skip - 1;
+    memcpy(piece->coef, values + skip, sizeof(double) * (count - skip));
+    return bounded && piece->to <= piece->from ? -1 : 0;
+}
+
+// Ширина территории в x: нечетные границы минус четные, все кривые в одном проходе
+static double bounds_eval(double x)
+{
+    double width = 0.0;
+    for (int k = 0; k < bounds_count; k++)
+    {
+        width += k % 2 == 1 ? profile_eval(&bounds[k], x) : -profile_eval(&bounds[k], x);
+    }
+    return width;
+}
+
+static int compare_doubles(const void *left, const void *right)
+{
+    double l = *(const double *)left, r = *(const double *)right;
+    return (l > r) - (l < r);
+}
+
+// Кусок профиля, внутри которого лежит x, NULL - вне кусков
+static const piece_t *piece_at(const profile_t *profile, double x)
+{
+    for (int i = 0; i < profile->num_pieces; i++)
+    {
+        if (profile->pieces[i].from < x && x < profile->pieces[i].to)
+        {
+            return &profile->pieces[i];
+        }
+    }
+    return NULL;
+}
+
+// Сливает многочлены границ в куски разности: между соседними точками разбиения всех
+// границ разность - тоже многочлен. Возвращает -1, если кусков больше MAX_PIECES.
+static int merge_bounds(profile_t *profile)
+{
+    double points[MAX_BOUNDS * MAX_PIECES * 2], x;
+    int count = 0;
+    piece_t piece;
+    const piece_t *part;
+
+    for (int k = 0; k < bounds_count; k++)
+    {
+        for (int i = 0; i < bounds[k].num_pieces; i++)
+        {
+            points[count++] = bounds[k].pieces[i].from;
+            points[count++] = bounds[k].pieces[i].to;
+        }
+    }
+    qsort(points, count, sizeof(double), compare_doubles);
+    for (int j = 0; j + 1 < count; j++)
+    {
+        if (points[j] == points[j + 1])
+        {
+            continue;
+        }
+        // Точка внутри промежутка, по ней видно, какие куски его покрывают
+        x = isinf(points[j]) && isinf(points[j + 1]) ? 0.0
+            : isinf(points[j])                       ? points[j + 1] - 1.0
+            : isinf(points[j + 1])                   ? points[j] + 1.0
+                                                     : (points[j] + points[j + 1]) / 2;
+        memset(&piece, 0, sizeof(piece));
+        piece.from = points[j];
+        piece.to = points[j + 1];
+        piece.degree = -1;
+        for (int k = 0; k < bounds_count; k++)
+        {
+            if ((part = piece_at(&bounds[k], x)) == NULL)
+            {
+                continue;
+            }
+            for (int d = 0; d <= part->degree; d++)
+            {
+                piece.coef[d] += k % 2 == 1 ? part->coef[d] : -part->coef[d];
+            }
+            piece.degree = part->degree > piece.degree ? part->degree : piece.degree;
+        }
+        if (piece.degree == -1)
+        {
+            continue; // вне кусков всех границ ширина 0
+        }
+        // Соседний кусок с тем же многочленом просто продлевается
+        if (profile->num_pieces > 0 && profile->pieces[profile->num_pieces - 1].to == piece.from &&
+            profile->pieces[profile->num_pieces - 1].degree == piece.degree &&
+            memcmp(profile->pieces[profile->num_pieces - 1].coef, piece.coef, sizeof(piece.coef)) == 0)
+        {
+            profile->pieces[profile->num_pieces - 1].to = piece.to;
+            continue;
+        }
+        if (profile->num_pieces == MAX_PIECES)
+        {
+            return -1;
+        }
+        profile->pieces[profile->num_pieces++] = piece;
+    }
+    return 0;
+}
+
+// bounds:СЕВЕР|БЕРЕГ|БЕРЕГ|...: территория между границами 0 и 1, 2 и 3 и т.д.
+static int parse_bounds(const char *spec, profile_t *profile)
+{
+    char part[sizeof(profile->name)];
+    const char *bar;
+    bool polynomial = true;
+    size_t length;
+
+    bounds_count = 0;
+    for (const char *text = spec; text != NULL; text = bar != NULL ? bar + 1 : NULL)
+    {
+        bar = strchr(text, '|');
+        length = bar != NULL ? (size_t)(bar - text) : strlen(text);
+        if (bounds_count == MAX_BOUNDS || length >= sizeof(part) || strncmp(text, "bounds:", 7) == 0)
+        {
+            return -1;
+        }
+        memcpy(part, text, length);
+        part[length] = '\0';
+        if (profile_parse(part, &bounds[bounds_count]) == -1)
+        {
+            return -1;
+        }
+        polynomial = polynomial && bounds[bounds_count].num_pieces > 0;
+        bounds_count++;
+    }
+    if (bounds_count < 2 || bounds_count % 2 != 0)
+    {
+        return -1;
+    }
+    // Многочлены сливаются в один профиль: ядра и точная площадь работают как с одной кривой
+    if (polynomial && merge_bounds(profile) == 0)
+    {
+        return 0;
+    }
+    profile->num_pieces = 0;
+    profile->fn = bounds_eval;
+    return 0;
+}
+
+int profile_parse(const char *spec, profile_t *profile)
+{
+    memset(profile, 0, sizeof(*profile));
+    snprintf(profile->name, sizeof(profile->name), "%s", spec);
+    if (strcmp(spec, "default") == 0)
+    {
+        // По точкам считаем как раньше, а куски нужны для точного ответа и векторных ядер
+        profile->fn = river_default;
+        profile->num_pieces = 1;
+        return parse_piece("0,0,0.001", &profile->pieces[0], false);
+    }
+    if (strcmp(spec, "wave") == 0)
+    {
+        profile->fn = river_wave;
+        return 0;
+    }
+    if (strncmp(spec, "poly:", 5) == 0)
+    {
+        profile->num_pieces = 1;
+        return parse_piece(spec + 5, &profile->pieces[0], false);
+    }
+    if (strncmp(spec, "bounds:", 7) == 0)
+    {
+        return parse_bounds(spec + 7, profile);
+    }
+    if (strncmp(spec, "pw:", 3) == 0)
+    {
+        for (const char *text = spec + 3; text != NULL; text = strchr(text, ';') ? strchr(text, ';') + 1 : NULL)
+        {
+            if (profile->num_pieces == MAX_PIECES ||
+                parse_piece(text, &profile->pieces[profile->num_pieces], true) == -1)
+            {
+                return -1;
+            }
+            // Куски должны идти по возрастанию и не пересекаться
+            if (profile->num_pieces > 0 &&
+                profile->pieces[profile->num_pieces].from < profile->pieces[profile->num_pieces - 1].to)
+            {
+                return -1;
+            }
+            profile->num_pieces++;
+        }
+        return 0;
+    }
+    return -1;
+}
+
+double profile_eval(const profile_t *profile, double x)
+{
+    int lo = 0, hi = profile->num_pieces - 1, mid;
+    if (profile->fn != NULL)
+    {
+        return profile->fn(x);
+    }
+    // Двоичный поиск куска, содержащего x
+    while (lo <= hi)
+    {
+        mid = (lo + hi) / 2;
+        if (x < profile->pieces[mid].from)
+        {
+            hi = mid - 1;
+        }
+        else if (x > profile->pieces[mid].to)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            return horner(&profile->pieces[mid], x);
+        }
+    }
+    return 0.0;
+}
+
+bool profile_exact(const profile_t *profile, double a, double b, double *area)
+{
+    double sign = 1.0, from, to;
+    if (profile->num_pieces == 0)
+    {
+        return false;
+    }
+    if (a > b)
+    {
+        sign = a;
+        a = b;
+        b = sign;
+        sign = -1.0;
+    }
+    *area = 0.0;
+    for (int i = 0; i < profile->num_pieces; i++)
+    {
+        from = fmax(a, profile->pieces[i].from);
+        to = fmin(b, profile->pieces[i].to);
+        if (from < to)
+        {
+            *area += antiderivative(&profile->pieces[i], to) - antiderivative(&profile->pieces[i], from);
+        }
+    }
+    *area *= sign;
+    return true;
+}
@@ -0,0 +1,46 @@
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdbool.h>
+
+#define MAX_PIECES 16
+#define MAX_DEGREE 8
+#define MAX_BOUNDS 8 // границ территории в профиле bounds:
+
+// Кусок многочлена c0 + c1 x + ... + cn x^n на [from, to]
+typedef struct
+{
+    double from, to;
+    int degree;
+    double coef[MAX_DEGREE + 1];
+} piece_t;
+
+// Профиль реки. Если известны куски, площадь под ним считается точно, и ядра средних
+// прямоугольников (precision.c) тоже считают по кускам, векторно, даже если fn задана.
+// fn (если задана) - значение f(x) в одной точке для profile_eval, правил Гаусса и
+// адаптивного подсчета, а без кусков - и для средних прямоугольников.
+typedef struct
+{
+    char name[512]; // описание, по которому профиль был разобран
+    double (*fn)(double x); // NULL - вычислять по кускам
+    int num_pieces;         // 0 - профиль не многочлен
+    piece_t pieces[MAX_PIECES];
+} profile_t;
+
+// Профиль, который сейчас считают счетоводы
+extern profile_t river;
+
+// Разбирает описание профиля:
+//   default                      - x * x / 1000
+//   wave                         - 5 + sin(x / 10), не многочлен
+//   poly:c0,c1,...               - многочлен на всей прямой
+//   pw:from,to,c0,c1,...;...     - кусочный многочлен, вне кусков f = 0
+//   bounds:g0|g1|g2|g3...        - территория между кривыми: f = g1 - g0 + g3 - g2 + ...
+int profile_parse(const char *spec, profile_t *profile);
+
+double profile_eval(const profile_t *profile, double x);
+
+// Точная площадь под профилем на [a, b], false если профиль не многочлен
+bool profile_exact(const profile_t *profile, double a, double b, double *area);
+
+#endif
@@ -0,0 +1,65 @@
+// Сгенерировано gen_quadrature.c, руками не редактировать
+#ifndef QUADRATURE_TABLES_H
+#define QUADRATURE_TABLES_H
+
+// Гаусс-Лежандр, 2 узлов, точен для многочленов степени до 3
+static const double gl2_x[2] = {
+    5.773502691896257645065e-01, -5.773502691896257645065e-01};
+static const double gl2_w[2] = {
+    1.000000000000000000000e+00, 1.000000000000000000000e+00};
+
+// Гаусс-Лежандр, 4 узлов, точен для многочленов степени до 7
+static const double gl4_x[4] = {
+    8.611363115940525751941e-01, 3.399810435848562647923e-01, -3.399810435848562647923e-01,
+    -8.611363115940525751941e-01};
+static const double gl4_w[4] = {
+    3.478548451374538574377e-01, 6.521451548625461426979e-01, 6.521451548625461426979e-01,
+    3.478548451374538574377e-01};
+
+// Гаусс-Лежандр, 8 узлов, точен для многочленов степени до 15
+static const double gl8_x[8] = {
+    9.602898564975362316609e-01, 7.966664774136267396210e-01, 5.255324099163289858303e-01,
+    1.834346424956498049496e-01, -1.834346424956498049496e-01, -5.255324099163289858303e-01,
+    -7.966664774136267396210e-01, -9.602898564975362316609e-01};
+static const double gl8_w[8] = {
+    1.012285362903762592218e-01, 2.223810344533744705320e-01, 3.137066458778872872840e-01,
+    3.626837833783619829487e-01, 3.626837833783619829487e-01, 3.137066458778872872840e-01,
+    2.223810344533744705320e-01, 1.012285362903762592218e-01};
+
+// Гаусс-Лежандр, 16 узлов, точен для многочленов степени до 31
+static const double gl16_x[16] = {
+    9.894009349916499326013e-01, 9.445750230732325760903e-01, 8.656312023878317438662e-01,
+    7.554044083550030338906e-01, 6.178762444026437484525e-01, 4.580167776572273863496e-01,
+    2.816035507792589132308e-01, 9.501250983763744018088e-02, -9.501250983763744018088e-02,
+    -2.816035507792589132308e-01, -4.580167776572273863496e-01, -6.178762444026437484525e-01,
+    -7.554044083550030338906e-01, -8.656312023878317438662e-01, -9.445750230732325760903e-01,
+    -9.894009349916499326013e-01};
+static const double gl16_w[16] = {
+    2.715245941175409480735e-02, 6.225352393864789283566e-02, 9.515851168249278482086e-02,
+    1.246289712555338720490e-01, 1.495959888165767320931e-01, 1.691565193950025382513e-01,
+    1.826034150449235888723e-01, 1.894506104550684963010e-01, 1.894506104550684963010e-01,
+    1.826034150449235888723e-01, 1.691565193950025382513e-01, 1.495959888165767320931e-01,
+    1.246289712555338720490e-01, 9.515851168249278482086e-02, 6.225352393864789283566e-02,
+    2.715245941175409480735e-02};
+
+// Гаусс-Кронрод 15 с вложенным Гауссом 7 (вес Гаусса 0 на узлах только Кронрода)
+static const double gk15_x[15] = {
+    9.914553711208126392067e-01, 9.491079123427585245406e-01, 8.648644233597690727708e-01,
+    7.415311855993944398636e-01, 5.860872354676911303055e-01, 4.058451513773971669171e-01,
+    2.077849550078984676004e-01, 0.000000000000000000000e+00, -2.077849550078984676004e-01,
+    -4.058451513773971669171e-01, -5.860872354676911303055e-01, -7.415311855993944398636e-01,
+    -8.648644233597690727708e-01, -9.491079123427585245406e-01, -9.914553711208126392067e-01};
+static const double gk15_wk[15] = {
+    2.293532201052922496433e-02, 6.309209262997855329397e-02, 1.047900103222501838366e-01,
+    1.406532597155259187497e-01, 1.690047266392679028307e-01, 1.903505780647854099075e-01,
+    2.044329400752988924094e-01, 2.094821410847278280159e-01, 2.044329400752988924094e-01,
+    1.903505780647854099075e-01, 1.690047266392679028307e-01, 1.406532597155259187497e-01,
+    1.047900103222501838366e-01, 6.309209262997855329397e-02, 2.293532201052922496433e-02};
+static const double gk15_wg[15] = {
+    0.000000000000000000000e+00, 1.294849661688696932738e-01, 0.000000000000000000000e+00,
+    2.797053914892766678904e-01, 0.000000000000000000000e+00, 3.818300505051189449614e-01,
+    0.000000000000000000000e+00, 4.179591836734693877488e-01, 0.000000000000000000000e+00,
+    3.818300505051189449614e-01, 0.000000000000000000000e+00, 2.797053914892766678904e-01,
+    0.000000000000000000000e+00, 1.294849661688696932738e-01, 0.000000000000000000000e+00};
+
+#endif
@@ -0,0 +1,103 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "results.h"
+
+#define WRITE_BUFFER (1 << 20) // файлы пишутся кусками по мегабайту
+
+double child_process(int i, double from, double to, int all_op, const job_t *job, region_record_t *record)
+{
+    struct timespec started, finished;
+    long long evals = 0;
+
+    clock_gettime(CLOCK_MONOTONIC, &started);
+    record->area = integrate_region(job, from, to, all_op, &evals);
+    clock_gettime(CLOCK_MONOTONIC, &finished);
+    record->from = from;
+    record->to = to;
+    record->evals = evals;
+    record->nanos = (finished.tv_sec - started.tv_sec) * 1000000000LL + (finished.tv_nsec - started.tv_nsec);
+    // Номер счетовода пишется последним: запись с ним уже заполнена
+    record->worker = i;
+    return record->area;
+}
+
+void results_text(FILE *outfile, const region_record_t *records, int count)
+{
+    for (int k = 0; k < count; k++)
+    {
+        if (records[k].worker == 0)
+        {
+            continue;
+        }
+        fprintf(outfile, "Счетовод [%d] считал %.2f - %.2f и получил: %lf кв.м\n",
+                records[k].worker, records[k].from, records[k].to, records[k].area);
+    }
+}
+
+// Открывает файл с большим буфером, чтобы запись шла крупными кусками
+static FILE *open_buffered(const char *path, const char *mode, char **buffer)
+{
+    FILE *file;
+    if ((file = fopen(path, mode)) == NULL)
+    {
+        perror("Ошибка при открытии файла результатов");
+        return NULL;
+    }
+    if ((*buffer = malloc(WRITE_BUFFER)) != NULL)
+    {
+        setvbuf(file, *buffer, _IOFBF, WRITE_BUFFER);
+    }
+    return file;
+}
+
+static int close_buffered(FILE *file, char *buffer, const char *path)
+{
+    int result = 0;
+    if (ferror(file) || fclose(file) == EOF)
+    {
+        printf("Ошибка при записи результатов в %s\n", path);
+        result = -1;
+    }
+    free(buffer);
+    return result;
+}
+
+int results_binary(const char *path, const job_t *job, int workers, const region_record_t *records, int count)
+{
+    results_header_t header = {0};
+    char *buffer = NULL;
+    FILE *file;
+
+    if ((file = open_buffered(path, "wb", &buffer)) == NULL)
+    {
+        return -1;
+    }
+    memcpy(header.magic, RESULTS_MAGIC, sizeof(header.magic));
+    header.count = count;
+    header.workers = workers;
+    header.a = job->a;
+    header.b = job->b;
+    fwrite(&header, sizeof(header), 1, file);
+    fwrite(records, sizeof(region_record_t), count, file);
+    return close_buffered(file, buffer, path);
+}
+
+int results_csv(const char *path, const region_record_t *records, int count)
+{
+    char *buffer = NULL;
+    FILE *file;
+
+    if ((file = open_buffered(path, "w", &buffer)) == NULL)
+    {
+        return -1;
+    }
+    fprintf(file, "worker,from,to,area,evals,nanos\n");
+    for (int k = 0; k < count; k++)
+    {
+        fprintf(file, "%d,%.17g,%.17g,%.17g,%lld,%lld\n", records[k].worker, records[k].from, records[k].to,
+                records[k].area, (long long)records[k].evals, (long long)records[k].nanos);
+    }
+    return close_buffered(file, buffer, path);
+}
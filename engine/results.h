@@ -0,0 +1,43 @@
+#ifndef RESULTS_H
+#define RESULTS_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include "area.h"
+
+#define RESULTS_MAGIC "AREAREC1"
+
+// Запись о посчитанном районе. Счетоводы заполняют их в общей памяти,
+// а в файлы их пишет один агроном после работы.
+typedef struct
+{
+    int32_t worker; // счетовод (с 1), 0 - район не посчитан
+    int32_t reserved;
+    double from, to;
+    double area;
+    int64_t evals; // вычислений f(x) на район
+    int64_t nanos; // время подсчета района
+} region_record_t;
+
+// Заголовок двоичного файла, за ним идут count записей region_record_t
+typedef struct
+{
+    char magic[8]; // RESULTS_MAGIC
+    int32_t count;
+    int32_t workers;
+    double a, b;
+} results_header_t;
+
+// Счетовод i считает район [from, to], заполняет его запись и возвращает площадь
+double child_process(int i, double from, double to, int all_op, const job_t *job, region_record_t *record);
+
+// Строки "Счетовод [i] считал ..." в выходной файл, по порядку районов
+void results_text(FILE *outfile, const region_record_t *records, int count);
+
+// Двоичный файл записей задания одной последовательной записью
+int results_binary(const char *path, const job_t *job, int workers, const region_record_t *records, int count);
+
+// Те же записи в CSV
+int results_csv(const char *path, const region_record_t *records, int count);
+
+#endif
@@ -0,0 +1,74 @@
+#include <string.h>
+#include <math.h>
+#include "area.h"
+#include "rules.h"
+#include "quadrature_tables.h"
+
+static double midpoint_panel(double a, double b, double *error)
+{
+    *error = 0.0;
+    return (b - a) * f((a + b) / 2);
+}
+
+// Для каждого порядка своя функция с известным на этапе компиляции числом узлов,
+// поэтому цикл по узлам разворачивается полностью.
+#define GAUSS_PANEL(n)                                              \
+    static double gauss##n##_panel(double a, double b, double *error) \
+    {                                                               \
+        double c = (a + b) / 2, r = (b - a) / 2, sum = 0.0;         \
+        _Pragma("GCC unroll 16") for (int k = 0; k < n; k++)        \
+        {                                                           \
+            sum += gl##n##_w[k] * f(c + r * gl##n##_x[k]);          \
+        }                                                           \
+        *error = 0.0;                                               \
+        return r * sum;                                             \
+    }
+
+GAUSS_PANEL(2)
+GAUSS_PANEL(4)
+GAUSS_PANEL(8)
+GAUSS_PANEL(16)
+
+// Кронрод 15 и вложенный Гаусс 7 на одних и тех же значениях f(x)
+static double gk15_panel(double a, double b, double *error)
+{
+    double c = (a + b) / 2, r = (b - a) / 2, fx, kronrod = 0.0, gauss = 0.0;
+#pragma GCC unroll 16
+    for (int k = 0; k < 15; k++)
+    {
+        fx = f(c + r * gk15_x[k]);
+        kronrod += gk15_wk[k] * fx;
+        gauss += gk15_wg[k] * fx;
+    }
+    *error = fabs(r * (kronrod - gauss));
+    return r * kronrod;
+}
+
+const rule_t rule_midpoint = {"midpoint", "средние прямоугольники (как в 4-8 баллах, по умолчанию)", 1, false, midpoint_panel};
+static const rule_t rule_gl2 = {"gl2", "Гаусс-Лежандр, 2 узла", 2, false, gauss2_panel};
+static const rule_t rule_gl4 = {"gl4", "Гаусс-Лежандр, 4 узла", 4, false, gauss4_panel};
+static const rule_t rule_gl8 = {"gl8", "Гаусс-Лежандр, 8 узлов", 8, false, gauss8_panel};
+static const rule_t rule_gl16 = {"gl16", "Гаусс-Лежандр, 16 узлов", 16, false, gauss16_panel};
+static const rule_t rule_gk15 = {"gk15", "Гаусс-Кронрод 15 с оценкой ошибки по Гауссу 7", 15, true, gk15_panel};
+
+const rule_t *const rules[] = {
+    &rule_midpoint,
+    &rule_gl2,
+    &rule_gl4,
+    &rule_gl8,
+    &rule_gl16,
+    &rule_gk15,
+    NULL,
+};
+
+const rule_t *rule_find(const char *name)
+{
+    for (int i = 0; rules[i] != NULL; i++)
+    {
+        if (strcmp(rules[i]->name, name) == 0)
+        {
+            return rules[i];
+        }
+    }
+    return NULL;
+}
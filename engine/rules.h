@@ -0,0 +1,25 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include <stdbool.h>
+
+// Квадратурное правило для одной панели [a, b]
+typedef struct
+{
+    const char *name;
+    const char *description;
+    int points;    // вычислений f(x) на одну панель
+    bool embedded; // правило само оценивает свою ошибку
+    // Площадь панели, в *error оценка ошибки (0, если правило её не даёт)
+    double (*panel)(double a, double b, double *error);
+} rule_t;
+
+extern const rule_t rule_midpoint;
+
+// Все правила, последний элемент NULL
+extern const rule_t *const rules[];
+
+// Ищет правило по имени, NULL если такого нет
+const rule_t *rule_find(const char *name);
+
+#endif
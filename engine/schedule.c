@@ -0,0 +1,123 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include "schedule.h"
+#include "shared.h"
+
+int schedule_parse(const char *spec, schedule_t *schedule)
+{
+    const char *comma = strchr(spec, ',');
+    size_t length = comma != NULL ? (size_t)(comma - spec) : strlen(spec);
+
+    memset(schedule, 0, sizeof(*schedule));
+    schedule->chunk = 1;
+    schedule->pieces = 1;
+    if (length == 6 && strncmp(spec, "static", 6) == 0)
+    {
+        schedule->kind = SCHEDULE_STATIC;
+    }
+    else if (length == 7 && strncmp(spec, "dynamic", 7) == 0)
+    {
+        schedule->kind = SCHEDULE_DYNAMIC;
+    }
+    else if (length == 6 && strncmp(spec, "guided", 6) == 0)
+    {
+        schedule->kind = SCHEDULE_GUIDED;
+    }
+    else
+    {
+        return -1;
+    }
+    if (comma != NULL && (schedule->chunk = atoi(comma + 1)) < 1)
+    {
+        return -1;
+    }
+    // Просто static без размера куска - прежняя раздача районов целиком
+    schedule->pieces = schedule->kind == SCHEDULE_STATIC && comma == NULL ? 1 : SCHEDULE_GRAIN;
+    return 0;
+}
+
+int schedule_init(schedule_t *schedule, int count, int max_pieces, int max_workers)
+{
+    if (schedule->pieces > max_pieces)
+    {
+        schedule->pieces = max_pieces;
+    }
+    schedule->units = count * schedule->pieces;
+    schedule->workers = schedule->units < max_workers ? schedule->units : max_workers;
+    if ((schedule->progress = anon_shared(sizeof(schedule_progress_t), false)) == MAP_FAILED)
+    {
+        perror("Ошибка при разметке курсора раздачи");
+        schedule->progress = NULL;
+        return -1;
+    }
+    memset(schedule->progress, 0, sizeof(schedule_progress_t));
+    return schedule->workers;
+}
+
+bool schedule_next(const schedule_t *schedule, int worker, int *state, int *first, int *last)
+{
+    int size, remaining;
+    if (schedule->kind == SCHEDULE_STATIC)
+    {
+        // Блоки по chunk частей по кругу: счетоводу i достаются блоки i-1, i-1+workers, ...
+        *first = ((*state)++ * schedule->workers + worker - 1) * schedule->chunk;
+    }
+    else if (schedule->kind == SCHEDULE_DYNAMIC)
+    {
+        *first = __atomic_fetch_add(&schedule->progress->cursor, schedule->chunk, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        // Берем долю оставшегося по числу счетоводов, пока курсор никто не сдвинул
+        *first = __atomic_load_n(&schedule->progress->cursor, __ATOMIC_RELAXED);
+        do
+        {
+            remaining = schedule->units - *first;
+            if (remaining <= 0)
+            {
+                return false;
+            }
+            size = (remaining + schedule->workers - 1) / schedule->workers;
+            size = size < schedule->chunk ? schedule->chunk : size;
+        } while (!__atomic_compare_exchange_n(&schedule->progress->cursor, first, *first + size, false,
+                                              __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+        *last = *first + size < schedule->units ? *first + size : schedule->units;
+        return true;
+    }
+    if (*first >= schedule->units)
+    {
+        return false;
+    }
+    *last = *first + schedule->chunk < schedule->units ? *first + schedule->chunk : schedule->units;
+    return true;
+}
+
+void schedule_done(const schedule_t *schedule, long long nanos)
+{
+    __atomic_fetch_add(&schedule->progress->done, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&schedule->progress->nanos, nanos, __ATOMIC_RELAXED);
+}
+
+int schedule_pending(const schedule_t *schedule)
+{
+    int cursor = __atomic_load_n(&schedule->progress->cursor, __ATOMIC_RELAXED);
+    return cursor < schedule->units ? schedule->units - cursor : 0;
+}
+
+const char *schedule_name(const schedule_t *schedule, char *name, int size)
+{
+    static const char *const kinds[] = {"static", "dynamic", "guided"};
+    snprintf(name, size, "%s,%d (частей на район: %d)", kinds[schedule->kind], schedule->chunk, schedule->pieces);
+    return name;
+}
+
+void schedule_free(schedule_t *schedule)
+{
+    if (schedule->progress != NULL)
+    {
+        munmap(schedule->progress, sizeof(schedule_progress_t));
+        schedule->progress = NULL;
+    }
+}
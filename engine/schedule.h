@@ -0,0 +1,57 @@
+#ifndef SCHEDULE_H
+#define SCHEDULE_H
+
+#include <stdbool.h>
+
+#define SCHEDULE_GRAIN 16 // на сколько частей делится район при раздаче кусками
+
+// Как районы раздаются счетоводам, по образцу schedule в OpenMP
+typedef enum
+{
+    SCHEDULE_STATIC,  // заранее по кругу блоками по chunk частей
+    SCHEDULE_DYNAMIC, // по chunk частей из общего курсора, кто освободился
+    SCHEDULE_GUIDED   // из общего курсора, куски уменьшаются к концу, но не меньше chunk
+} schedule_kind_t;
+
+// Ход раздачи в общей памяти
+typedef struct
+{
+    int cursor;       // первая еще не розданная часть (dynamic и guided)
+    int done;         // сколько частей уже посчитано
+    long long nanos;  // сколько времени ушло на посчитанные части
+} schedule_progress_t;
+
+typedef struct
+{
+    schedule_kind_t kind;
+    int chunk;
+    int pieces;  // частей на район, 1 - район целиком
+    int units;   // всего частей
+    int workers;
+    schedule_progress_t *progress;
+} schedule_t;
+
+// Разбирает "static", "static,4", "dynamic", "dynamic,2", "guided", "guided,2"
+int schedule_parse(const char *spec, schedule_t *schedule);
+
+// Готовит раздачу count районов, вызывается до fork. max_pieces - на сколько частей
+// можно делить район (для средних прямоугольников - не больше числа шагов).
+// Возвращает число счетоводов: частей может оказаться меньше, чем max_workers.
+int schedule_init(schedule_t *schedule, int count, int max_pieces, int max_workers);
+
+// Следующие части [*first, *last) для счетовода worker (с 1). state - счетчик самого
+// счетовода, перед первым вызовом 0. Возвращает false, когда части кончились.
+bool schedule_next(const schedule_t *schedule, int worker, int *state, int *first, int *last);
+
+// Счетовод посчитал часть за nanos наносекунд
+void schedule_done(const schedule_t *schedule, long long nanos);
+
+// Сколько частей еще никто не взял (для dynamic и guided)
+int schedule_pending(const schedule_t *schedule);
+
+// Описание политики для вывода
+const char *schedule_name(const schedule_t *schedule, char *name, int size);
+
+void schedule_free(schedule_t *schedule);
+
+#endif
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include "shared.h"
+
+size_t huge_round(size_t size)
+{
+    return (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+}
+
+void *map_shared(int fd, size_t size, bool huge)
+{
+    void *ptr;
+    if (huge)
+    {
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_HUGETLB, fd, 0);
+        if (ptr != MAP_FAILED)
+        {
+            return ptr;
+        }
+        // tmpfs не умеет MAP_HUGETLB, просим у ядра прозрачные huge-страницы
+        printf("MAP_HUGETLB недоступен, пробуем MADV_HUGEPAGE...\n");
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr != MAP_FAILED && madvise(ptr, size, MADV_HUGEPAGE) == -1)
+        {
+            perror("Huge-страницы недоступны, работаем на обычных");
+        }
+        return ptr;
+    }
+    return mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+}
+
+void *anon_shared(size_t size, bool huge)
+{
+    void *ptr;
+    if (huge)
+    {
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+        {
+            return ptr;
+        }
+        perror("Не удалось выделить huge-страницы (MAP_HUGETLB), работаем на обычных");
+    }
+    return mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+}
+
+int get_shared(key_t key, size_t size, bool huge)
+{
+    int id;
+    if (huge)
+    {
+        id = shmget(key, huge_round(size), IPC_CREAT | SHM_HUGETLB | 0666);
+        if (id != -1)
+        {
+            return id;
+        }
+        perror("Не удалось выделить huge-страницы (SHM_HUGETLB), работаем на обычных");
+    }
+    return shmget(key, size, IPC_CREAT | 0666);
+}
@@ -0,0 +1,22 @@
+#ifndef SHARED_H
+#define SHARED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// Округляет размер до границы huge-страницы
+size_t huge_round(size_t size);
+
+// Отображает POSIX объект общей памяти, при huge пробует huge-страницы
+void *map_shared(int fd, size_t size, bool huge);
+
+// Анонимная общая память, наследуемая через fork
+void *anon_shared(size_t size, bool huge);
+
+// Создаёт сегмент SYSTEM V, при huge пробует SHM_HUGETLB
+int get_shared(key_t key, size_t size, bool huge);
+
+#endif
@@ -0,0 +1,45 @@
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "slots.h"
+#include "shared.h"
+
+#define CACHE_LINE 64
+
+int slots_init(slots_t *slots, int count, bool local, bool huge)
+{
+    slots->count = count;
+    // Без local ячейки только разносятся по кэш-линиям, чтобы не было ложного разделения
+    slots->stride = local ? (size_t)sysconf(_SC_PAGESIZE) : CACHE_LINE;
+    slots->size = slots->stride * count;
+    // На huge-странице все ячейки окажутся на одном узле, поэтому local важнее
+    if (huge && !local)
+    {
+        slots->size = huge_round(slots->size);
+    }
+    else
+    {
+        huge = false;
+    }
+    if ((slots->base = anon_shared(slots->size, huge)) == MAP_FAILED)
+    {
+        perror("Ошибка при разметке ячеек счетоводов");
+        slots->base = NULL;
+        return -1;
+    }
+    return 0;
+}
+
+worker_slot_t *slot_at(const slots_t *slots, int i)
+{
+    return (worker_slot_t *)(slots->base + slots->stride * (i - 1));
+}
+
+void slots_free(slots_t *slots)
+{
+    if (slots->base != NULL)
+    {
+        munmap(slots->base, slots->size);
+        slots->base = NULL;
+    }
+}
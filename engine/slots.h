@@ -0,0 +1,34 @@
+#ifndef SLOTS_H
+#define SLOTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Личная ячейка счетовода в общей памяти, пишет в неё только он сам
+typedef struct
+{
+    double area;     // площадь района
+    long long evals; // сколько раз счетовод вычислил f(x)
+    double subtotal; // сумма группы, которую возглавляет этот счетовод (режим дерева)
+    int cpu;     // ядро, к которому был привязан счетовод
+    int node;    // NUMA-узел этого ядра
+} worker_slot_t;
+
+typedef struct
+{
+    char *base;
+    size_t stride;
+    size_t size;
+    int count;
+} slots_t;
+
+// Выделяет count ячеек. При local каждая ячейка лежит на своей странице,
+// и страница попадает на NUMA-узел счетовода, который первым её тронет.
+int slots_init(slots_t *slots, int count, bool local, bool huge);
+
+// Ячейка счетовода i (с 1)
+worker_slot_t *slot_at(const slots_t *slots, int i);
+
+void slots_free(slots_t *slots);
+
+#endif
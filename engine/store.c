@@ -0,0 +1,68 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include "store.h"
+
+#define SPEC_SIZE 1024
+#define NAME_SIZE 32
+#define LINE_SIZE (SPEC_SIZE + 256)
+
+int store_load(const char *path, const job_t *job, int steps, int pieces, interval_t **out)
+{
+    char spec[SPEC_SIZE], rule[NAME_SIZE], method[NAME_SIZE], line[LINE_SIZE];
+    double tol;
+    int record_steps, record_pieces, count = 0, capacity = 16;
+    interval_t item;
+    FILE *file;
+
+    job_method(job, method, sizeof(method));
+    *out = malloc(sizeof(interval_t) * capacity);
+    if ((file = fopen(path, "r")) == NULL)
+    {
+        if (errno == ENOENT)
+        {
+            return 0;
+        }
+        perror("Ошибка при открытии хранилища интервалов");
+        return -1;
+    }
+    // Строки старого вида без числа частей не подходят ни к одному ключу
+    while (fgets(line, sizeof(line), file) != NULL)
+    {
+        if (sscanf(line, "%1023s %31s %lf %d %d %lf %lf %lf", spec, rule, &tol, &record_steps, &record_pieces,
+                   &item.from, &item.to, &item.area) != 8 ||
+            strcmp(spec, river.name) != 0 || strcmp(rule, method) != 0 || tol != job->tol ||
+            record_steps != steps || record_pieces != pieces)
+        {
+            continue;
+        }
+        if (count == capacity)
+        {
+            capacity *= 2;
+            *out = realloc(*out, sizeof(interval_t) * capacity);
+        }
+        (*out)[count++] = item;
+    }
+    fclose(file);
+    return count;
+}
+
+int store_append(const char *path, const job_t *job, int steps, int pieces, const interval_t *items, int count)
+{
+    char method[NAME_SIZE];
+    FILE *file;
+    job_method(job, method, sizeof(method));
+    if ((file = fopen(path, "a")) == NULL)
+    {
+        perror("Ошибка при открытии хранилища интервалов");
+        return -1;
+    }
+    for (int i = 0; i < count; i++)
+    {
+        fprintf(file, "%s %s %.17g %d %d %.17g %.17g %.17g\n", river.name, method, job->tol, steps, pieces,
+                items[i].from, items[i].to, items[i].area);
+    }
+    fclose(file);
+    return 0;
+}
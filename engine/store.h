@@ -0,0 +1,18 @@
+#ifndef STORE_H
+#define STORE_H
+
+#include "area.h"
+
+// Хранилище площадей интервалов между запусками. Площадь интервала зависит
+// от профиля реки, правила, допуска, числа шагов (для средних прямоугольников)
+// и числа частей, на которые раздача режет интервал, поэтому из файла берутся
+// только записи с тем же ключом.
+
+// Загружает интервалы с ключом задания, отсутствующий файл - пустое хранилище.
+// Возвращает число интервалов или -1.
+int store_load(const char *path, const job_t *job, int steps, int pieces, interval_t **out);
+
+// Дописывает в хранилище новые интервалы
+int store_append(const char *path, const job_t *job, int steps, int pieces, const interval_t *items, int count);
+
+#endif
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <math.h>
+
+// Генератор таблиц узлов и весов для rules.c.
+// Узлы Гаусса-Лежандра ищутся методом Ньютона по многочлену Лежандра в long double,
+// узлы Кронрода 15 берутся из QUADPACK (qk15) и проверяются на точность по степеням x.
+// Сборка из папки engine: gcc -o gen_quadrature tools/gen_quadrature.c -lm && ./gen_quadrature > quadrature_tables.h
+
+#define GK15_POINTS 15
+#define MAX_POINTS 16
+
+// Положительная половина правила Кронрода 15 из QUADPACK, последний узел - центр
+static const long double gk15_half_x[8] = {
+    0.991455371120812639206854697526329L, 0.949107912342758524526189684047851L,
+    0.864864423359769072789712788640926L, 0.741531185599394439863864773280788L,
+    0.586087235467691130294144845693013L, 0.405845151377397166906606412076961L,
+    0.207784955007898467600689403773245L, 0.000000000000000000000000000000000L};
+static const long double gk15_half_wk[8] = {
+    0.022935322010529224963732008058970L, 0.063092092629978553290700663189204L,
+    0.104790010322250183839876322541518L, 0.140653259715525918745189590510238L,
+    0.169004726639267902826583426598550L, 0.190350578064785409913256402421014L,
+    0.204432940075298892414161999234649L, 0.209482141084727828012999174891714L};
+// Веса Гаусса 7 на нечетных узлах Кронрода (x[1], x[3], x[5], x[7])
+static const long double gk15_half_wg[8] = {
+    0.0L, 0.129484966168869693270611432679082L,
+    0.0L, 0.279705391489276667901467771423780L,
+    0.0L, 0.381830050505118944950369775488975L,
+    0.0L, 0.417959183673469387755102040816327L};
+
+// Значение многочлена Лежандра P_n(x) и его производной
+static void legendre(int n, long double x, long double *p, long double *dp)
+{
+    long double p0 = 1.0L, p1 = x, p2;
+    if (n == 0)
+    {
+        *p = 1.0L;
+        *dp = 0.0L;
+        return;
+    }
+    for (int k = 2; k <= n; k++)
+    {
+        p2 = ((2 * k - 1) * x * p1 - (k - 1) * p0) / k;
+        p0 = p1;
+        p1 = p2;
+    }
+    *p = p1;
+    *dp = n * (x * p1 - p0) / (x * x - 1.0L);
+}
+
+static void gauss_legendre(int n, long double *x, long double *w)
+{
+    long double p, dp, z, dz;
+    for (int i = 0; i < n; i++)
+    {
+        // Начальное приближение Чебышёва, узлы по убыванию
+        z = cosl(M_PI * (i + 0.75L) / (n + 0.5L));
+        for (int iter = 0; iter < 100; iter++)
+        {
+            legendre(n, z, &p, &dp);
+            dz = p / dp;
+            z -= dz;
+            if (fabsl(dz) <= 1e-19L)
+            {
+                break;
+            }
+        }
+        legendre(n, z, &p, &dp);
+        x[i] = z;
+        w[i] = 2.0L / ((1.0L - z * z) * dp * dp);
+    }
+}
+
+// Наибольшая ошибка правила на мономах x^0..x^degree на отрезке [-1, 1]
+static long double exactness(int n, const long double *x, const long double *w, int degree)
+{
+    long double worst = 0.0L, sum, exact;
+    for (int k = 0; k <= degree; k++)
+    {
+        sum = 0.0L;
+        for (int i = 0; i < n; i++)
+        {
+            sum += w[i] * powl(x[i], k);
+        }
+        exact = k % 2 == 0 ? 2.0L / (k + 1) : 0.0L;
+        if (fabsl(sum - exact) > worst)
+        {
+            worst = fabsl(sum - exact);
+        }
+    }
+    return worst;
+}
+
+static void print_table(const char *name, int n, const long double *values)
+{
+    printf("static const double %s[%d] = {", name, n);
+    for (int i = 0; i < n; i++)
+    {
+        printf("%s%s%.21Le", i % 3 == 0 ? "\n    " : "", i == 0 || i % 3 == 0 ? "" : " ", values[i]);
+        printf(i + 1 < n ? "," : "");
+    }
+    printf("};\n");
+}
+
+int main(void)
+{
+    static const int orders[] = {2, 4, 8, 16};
+    long double x[MAX_POINTS], w[MAX_POINTS], wg[MAX_POINTS];
+    char name[32];
+
+    printf("// Сгенерировано gen_quadrature.c, руками не редактировать\n");
+    printf("#ifndef QUADRATURE_TABLES_H\n#define QUADRATURE_TABLES_H\n\n");
+    for (size_t k = 0; k < sizeof(orders) / sizeof(orders[0]); k++)
+    {
+        int n = orders[k];
+        gauss_legendre(n, x, w);
+        if (exactness(n, x, w, 2 * n - 1) > 1e-15L)
+        {
+            fprintf(stderr, "Правило Гаусса %d не прошло проверку\n", n);
+            return 1;
+        }
+        printf("// Гаусс-Лежандр, %d узлов, точен для многочленов степени до %d\n", n, 2 * n - 1);
+        snprintf(name, sizeof(name), "gl%d_x", n);
+        print_table(name, n, x);
+        snprintf(name, sizeof(name), "gl%d_w", n);
+        print_table(name, n, w);
+        printf("\n");
+    }
+
+    // Разворачиваем половину Кронрода в полное правило на 15 узлов, центр не отражаем
+    for (int i = 0; i < 8; i++)
+    {
+        x[i] = gk15_half_x[i];
+        w[i] = gk15_half_wk[i];
+        wg[i] = gk15_half_wg[i];
+    }
+    for (int i = 0; i < 7; i++)
+    {
+        x[GK15_POINTS - 1 - i] = -gk15_half_x[i];
+        w[GK15_POINTS - 1 - i] = gk15_half_wk[i];
+        wg[GK15_POINTS - 1 - i] = gk15_half_wg[i];
+    }
+    if (exactness(GK15_POINTS, x, w, 22) > 1e-15L || exactness(GK15_POINTS, x, wg, 13) > 1e-15L)
+    {
+        fprintf(stderr, "Правило Гаусса-Кронрода 15 не прошло проверку\n");
+        return 1;
+    }
+    printf("// Гаусс-Кронрод 15 с вложенным Гауссом 7 (вес Гаусса 0 на узлах только Кронрода)\n");
+    print_table("gk15_x", GK15_POINTS, x);
+    print_table("gk15_wk", GK15_POINTS, w);
+    print_table("gk15_wg", GK15_POINTS, wg);
+    printf("\n#endif\n");
+    return 0;
+}
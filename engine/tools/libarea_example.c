@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <math.h>
+#include "../libarea.h"
+
+// Пример и проверка интерфейса libarea.so: площадь под 5 + sin(x / 10) сверяется с точной
+// по первообразной, синхронно и через area_submit, и должна совпадать до бита при 1, 2 и 8
+// потоках. Возвращает 1, если площадь не сошлась.
+// Сборка из папки engine после libarea.so:
+// gcc -O2 -Wall -o libarea_example tools/libarea_example.c -L. -larea -lm -Wl,-rpath,'$ORIGIN' && ./libarea_example
+
+static double wave(double x, void *context)
+{
+    return 5 + sin(x / 10);
+}
+
+static void done(const area_result_t *result, void *context)
+{
+    printf("Готово в потоке задания: %s, площадь %.10f\n", (const char *)context, result->area);
+}
+
+// Площадь не должна зависеть от числа потоков ни в одном бите
+static int same_for_threads(area_request_t request, const char *name)
+{
+    static const int threads[] = {1, 2, 8};
+    area_result_t first, result;
+    bool same = true;
+    for (int i = 0; i < 3; i++)
+    {
+        request.threads = threads[i];
+        area_integrate(&request, i == 0 ? &first : &result);
+        same = same && (i == 0 || (result.area == first.area && result.evals == first.evals));
+    }
+    printf("%-20s площадь при 1, 2 и 8 потоках %s\n", name, same ? "одна и та же: ок" : "разная: ОШИБКА");
+    return same ? 0 : 1;
+}
+
+static int report(const char *name, const area_result_t *result, double exact, double tol)
+{
+    bool ok = result->status == 0 && fabs(result->area - exact) <= tol;
+    printf("%-20s площадь %.10f, ошибка %.3e, оценка %.3e, вычислений %lld: %s\n", name, result->area,
+           fabs(result->area - exact), result->error, result->evals, ok ? "ок" : "ОШИБКА");
+    return ok ? 0 : 1;
+}
+
+int main(void)
+{
+    area_request_t request = {wave, NULL, 0, 20000, 1e-10, 0, 4, NULL};
+    area_result_t result;
+    area_task_t *task;
+    double exact = 5.0 * 20000 + 10.0 * (cos(0.0) - cos(20000 / 10.0));
+    int failures = 0;
+
+    area_integrate(&request, &result);
+    failures += report("area_integrate gk15", &result, exact, 1e-8);
+
+    request.tol = 0;
+    request.steps = 1000000;
+    request.threads = 0;
+    area_integrate(&request, &result);
+    failures += report("area_integrate mid", &result, exact, 1e-4);
+
+    failures += same_for_threads(request, "midpoint");
+    request.rule = "gl4";
+    failures += same_for_threads(request, "gl4");
+    request.rule = NULL;
+    request.tol = 1e-10;
+    failures += same_for_threads(request, "gk15");
+    if ((task = area_submit(&request, done, "gk15")) == NULL)
+    {
+        printf("Поток задания не создался\n");
+        return 1;
+    }
+    area_wait(task, &result);
+    failures += report("area_submit gk15", &result, exact, 1e-8);
+
+    // Неправильное задание: неизвестное правило
+    request.rule = "simpson?";
+    failures += area_integrate(&request, &result) == -1 ? 0 : 1;
+    printf("Неизвестное правило отвергнуто: %s\n", result.status == -1 ? "ок" : "ОШИБКА");
+    return failures > 0 ? 1 : 0;
+}
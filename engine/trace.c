@@ -0,0 +1,223 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "trace.h"
+#include "shared.h"
+
+typedef struct
+{
+    const char *name; // строковый литерал, после fork лежит по тому же адресу
+    int who;
+    pid_t pid;
+    long long start, end;
+    double from, to;
+    bool region;
+    bool instant;
+} trace_event_t;
+
+typedef struct
+{
+    int count; // сколько событий пытались записать, может превысить capacity
+    int capacity;
+    trace_event_t events[];
+} trace_buffer_t;
+
+static trace_buffer_t *buffer = NULL;
+static size_t buffer_size;
+static int self = 0;
+
+int trace_open(int capacity)
+{
+    buffer_size = sizeof(trace_buffer_t) + sizeof(trace_event_t) * capacity;
+    if ((buffer = anon_shared(buffer_size, false)) == MAP_FAILED)
+    {
+        perror("Ошибка при разметке памяти трассировки");
+        buffer = NULL;
+        return -1;
+    }
+    buffer->count = 0;
+    buffer->capacity = capacity;
+    return 0;
+}
+
+void trace_as(int who)
+{
+    self = who;
+}
+
+long long trace_now(void)
+{
+    struct timespec now;
+    if (buffer == NULL)
+    {
+        return 0;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static trace_event_t *trace_push(const char *name, long long start)
+{
+    int slot;
+    trace_event_t *event;
+    if (buffer == NULL)
+    {
+        return NULL;
+    }
+    // Переполненный буфер не мешает работе, лишние события просто теряются
+    if ((slot = __atomic_fetch_add(&buffer->count, 1, __ATOMIC_RELAXED)) >= buffer->capacity)
+    {
+        return NULL;
+    }
+    event = &buffer->events[slot];
+    event->name = name;
+    event->who = self;
+    event->pid = getpid();
+    event->start = start;
+    event->end = trace_now();
+    event->region = false;
+    event->instant = false;
+    return event;
+}
+
+void trace_span(const char *name, long long start)
+{
+    trace_push(name, start);
+}
+
+void trace_region(long long start, double from, double to)
+{
+    trace_event_t *event = trace_push("compute", start);
+    if (event != NULL)
+    {
+        event->region = true;
+        event->from = from;
+        event->to = to;
+    }
+}
+
+void trace_mark(const char *name)
+{
+    trace_event_t *event = trace_push(name, 0);
+    if (event != NULL)
+    {
+        event->start = event->end;
+        event->instant = true;
+    }
+}
+
+// Имя дорожки процесса на шкале
+static void track_name(int who, char *name, size_t size)
+{
+    if (who == 0)
+    {
+        snprintf(name, size, "Агроном");
+    }
+    else if (who > 0)
+    {
+        snprintf(name, size, "Счетовод %d", who);
+    }
+    else
+    {
+        snprintf(name, size, "Помощник агронома %d", -who);
+    }
+}
+
+// Отмечает pid в таблице уже встреченных процессов (открытая адресация, 0 - пустая ячейка).
+// true - процесс встретился впервые.
+static bool first_seen(pid_t *seen, int mask, pid_t pid)
+{
+    int slot = (unsigned)pid * 2654435761u & mask;
+    while (seen[slot] != 0 && seen[slot] != pid)
+    {
+        slot = (slot + 1) & mask;
+    }
+    if (seen[slot] == pid)
+    {
+        return false;
+    }
+    seen[slot] = pid;
+    return true;
+}
+
+int trace_save(const char *path)
+{
+    FILE *file;
+    pid_t root = getpid(), *seen;
+    int count, mask = 1;
+    char name[64];
+
+    if (buffer == NULL)
+    {
+        return -1;
+    }
+    if ((file = fopen(path, "w")) == NULL)
+    {
+        perror("Ошибка при открытии файла трассировки");
+        return -1;
+    }
+    count = buffer->count < buffer->capacity ? buffer->count : buffer->capacity;
+    // Таблица вдвое больше числа событий, чтобы поиск первого события процесса был за O(1)
+    while (mask < 2 * count)
+    {
+        mask <<= 1;
+    }
+    if ((seen = calloc(mask, sizeof(pid_t))) == NULL)
+    {
+        perror("Ошибка при выделении памяти трассировки");
+        fclose(file);
+        return -1;
+    }
+    mask--;
+    // Время в микросекундах CLOCK_MONOTONIC - те же часы, что у perf record -k CLOCK_MONOTONIC
+    fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n");
+    for (int k = 0; k < count; k++)
+    {
+        const trace_event_t *event = &buffer->events[k];
+        // Имя дорожки пишем при первом событии процесса
+        if (first_seen(seen, mask, event->pid))
+        {
+            track_name(event->who, name, sizeof(name));
+            fprintf(file, "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"name\": \"%s\"}},\n",
+                    root, event->pid, name);
+            fprintf(file, "{\"name\": \"thread_sort_index\", \"ph\": \"M\", \"pid\": %d, \"tid\": %d, \"args\": {\"sort_index\": %d}},\n",
+                    root, event->pid, event->who < 0 ? -event->who : event->who);
+        }
+        fprintf(file, "{\"name\": \"%s\", \"ph\": \"%s\", \"pid\": %d, \"tid\": %d, \"ts\": %.3f",
+                event->name, event->instant ? "i" : "X", root, event->pid, event->start / 1e3);
+        if (event->instant)
+        {
+            fprintf(file, ", \"s\": \"t\"");
+        }
+        else
+        {
+            fprintf(file, ", \"dur\": %.3f", (event->end - event->start) / 1e3);
+        }
+        if (event->region)
+        {
+            fprintf(file, ", \"args\": {\"from\": %.17g, \"to\": %.17g}", event->from, event->to);
+        }
+        fprintf(file, "}%s\n", k + 1 < count ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    fclose(file);
+    free(seen);
+    if (buffer->count > buffer->capacity)
+    {
+        printf("Трассировка: %d событий не поместились и потеряны\n", buffer->count - buffer->capacity);
+    }
+    return 0;
+}
+
+void trace_close(void)
+{
+    if (buffer != NULL)
+    {
+        munmap(buffer, buffer_size);
+        buffer = NULL;
+    }
+}
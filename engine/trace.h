@@ -0,0 +1,31 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+// Временная шкала работы в формате Chrome trace-event (chrome://tracing, Perfetto).
+// События пишутся в общую память, поэтому их видно из всех счетоводов.
+// Пока трассировка не открыта, все функции ничего не делают.
+
+// Выделяет место под capacity событий, вызывается агрономом до fork
+int trace_open(int capacity);
+
+// Номер процесса на шкале: 0 - агроном, i - счетовод i, -i - помощник над группой счетовода i
+void trace_as(int who);
+
+// Текущее время CLOCK_MONOTONIC в наносекундах (0, если трассировка выключена)
+long long trace_now(void);
+
+// Отрезок name от start до текущего момента
+void trace_span(const char *name, long long start);
+
+// Отрезок подсчета района [from, to] от start до текущего момента
+void trace_region(long long start, double from, double to);
+
+// Мгновенное событие
+void trace_mark(const char *name);
+
+// Сохраняет все события в файл, вызывается агрономом после завершения счетоводов
+int trace_save(const char *path);
+
+void trace_close(void);
+
+#endif